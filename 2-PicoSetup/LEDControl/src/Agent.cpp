@@ -56,6 +56,15 @@ TaskHandle_t Agent::getTask(){
 	return xHandle;
 }
 
+/***
+ * Perform one non blocking step of the agent's work, for a run loop
+ * that sleeps between steps
+ * @return ticks until the next step, portMAX_DELAY if none is needed
+ */
+TickType_t Agent::step(){
+	return portMAX_DELAY;
+}
+
 
 /***
  * Start the task
@@ -56,6 +56,13 @@ public:
 	 */
 	virtual TaskHandle_t getTask();
 
+	/***
+	 * Perform one non blocking step of the agent's work, for a run loop
+	 * that sleeps between steps
+	 * @return ticks until the next step, portMAX_DELAY if none is needed
+	 */
+	virtual TickType_t step();
+
 protected:
 	/***
 	 * Start the task via static function
@@ -0,0 +1,233 @@
+/*
+ * LEDPatternEngine.cpp
+ *
+ * Drives a set of LED channels, each running a step table pattern,
+ * from a single task.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "LEDPatternEngine.h"
+#include <stdio.h>
+
+/***
+ * Constructor
+ */
+LEDPatternEngine::LEDPatternEngine() {
+	xCmdQ = xQueueCreateStatic( LED_PATTERN_QUEUE_LEN,
+								sizeof(LEDPatternCmd),
+								xCmdQStorage,
+								&xCmdQStruct);
+	if (xCmdQ == NULL){
+		printf("Unable to create pattern queue\n");
+	}
+}
+
+/***
+ * Destructor
+ */
+LEDPatternEngine::~LEDPatternEngine() {
+	stop();
+}
+
+/***
+ * Add a channel on a GPIO pad. Must be called before start
+ * @param gp - GPIO pad number for LED
+ * @param pattern - initial pattern, NULL for off
+ * @return channel number or -1 if full
+ */
+int8_t LEDPatternEngine::add(uint8_t gp, const LEDPattern *pattern){
+	if (xCount >= LED_PATTERN_CHANNELS){
+		return -1;
+	}
+
+	gpio_init(gp);
+	gpio_set_dir(gp, GPIO_OUT);
+	gpio_put(gp, 0);
+
+	LEDChannel *ch = &xChannels[xCount];
+	ch->pad = gp;
+	begin(ch, pattern, xTaskGetTickCount());
+	xCount++;
+	return xCount - 1;
+}
+
+/***
+ * Set the pattern for a channel, applied on the next wake.
+ * Does not block
+ * @param channel
+ * @param pattern
+ * @return false if the channel or pattern is invalid or queue is full
+ */
+bool LEDPatternEngine::setPattern(uint8_t channel, const LEDPattern *pattern){
+	if ((channel >= xCount) || (pattern == NULL)){
+		return false;
+	}
+	LEDPatternCmd cmd = {channel, pattern};
+	return (xQueueSendToBack(xCmdQ, (void *)&cmd, 0) == pdTRUE);
+}
+
+/***
+ * Set a built in pattern by name for a channel
+ * @param channel
+ * @param name - pattern name
+ * @return false if the channel or name is invalid or queue is full
+ */
+bool LEDPatternEngine::setPattern(uint8_t channel, const char *name){
+	return setPattern(channel, LEDPatterns::find(name));
+}
+
+/***
+ * Update all channels and write changed outputs
+ * @return ticks until the next update is needed
+ */
+TickType_t LEDPatternEngine::step(){
+	uint64_t start = time_us_64();
+	TickType_t now = xTaskGetTickCount();
+	TickType_t next = portMAX_DELAY;
+	bool pwm = false;
+	uint32_t mask = 0;
+	uint32_t values = 0;
+	LEDPatternCmd cmd;
+
+	while (xQueueReceive(xCmdQ, (void *)&cmd, 0) == pdTRUE){
+		begin(&xChannels[cmd.channel], cmd.pattern, now);
+	}
+
+	for (uint8_t i=0; i < xCount; i++){
+		LEDChannel *ch = &xChannels[i];
+		uint8_t level = 0;
+
+		if (ch->pattern != NULL){
+			//Single step patterns hold their level
+			if (ch->pattern->count > 1){
+				while ((int32_t)(now - ch->due) >= 0){
+					ch->index = (ch->index + 1) % ch->pattern->count;
+					ch->due += stepTicks(&ch->pattern->steps[ch->index]);
+				}
+				if ((ch->due - now) < next){
+					next = ch->due - now;
+				}
+			}
+			level = ch->pattern->steps[ch->index].level;
+		}
+
+		bool on;
+		if (level == 0){
+			on = false;
+		} else if (level >= LED_PATTERN_LEVELS){
+			on = true;
+		} else {
+			on = ((now % LED_PATTERN_LEVELS) < level);
+			pwm = true;
+		}
+
+		uint32_t bit = 1UL << ch->pad;
+		if (on != ((xOut & bit) != 0)){
+			mask |= bit;
+			if (on){
+				values |= bit;
+			}
+		}
+	}
+
+	if (mask != 0){
+		gpio_put_masked(mask, values);
+		xOut = (xOut & ~mask) | values;
+	}
+
+	if (pwm){
+		next = 1;
+	}
+
+	xSteps++;
+	xBusyUs += time_us_64() - start;
+	return next;
+}
+
+/***
+ * Number of channels
+ * @return
+ */
+uint8_t LEDPatternEngine::getCount(){
+	return xCount;
+}
+
+/***
+ * Total time spent updating the channels
+ * @return micro seconds
+ */
+uint64_t LEDPatternEngine::getBusyUs(){
+	return xBusyUs;
+}
+
+/***
+ * Number of updates run
+ * @return
+ */
+uint32_t LEDPatternEngine::getSteps(){
+	return xSteps;
+}
+
+/***
+ * RAM used by the engine for each channel
+ * @return bytes
+ */
+size_t LEDPatternEngine::getChannelSize(){
+	return sizeof(LEDChannel);
+}
+
+/***
+ * Main Run Task for engine. Sleeps until the next step is due or
+ * a pattern change arrives
+ */
+void LEDPatternEngine::run(){
+	LEDPatternCmd cmd;
+
+	printf("Pattern engine started with %d channels\n", xCount);
+
+	while (true) { // Loop forever
+		TickType_t wait = step();
+		xQueuePeek(xCmdQ, (void *)&cmd, wait);
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE LEDPatternEngine::getMaxStackSize(){
+	return LED_PATTERN_STACK;
+}
+
+/***
+ * Start a channel at the first step of its pattern
+ * @param ch - channel
+ * @param pattern
+ * @param now - current tick
+ */
+void LEDPatternEngine::begin(LEDChannel *ch, const LEDPattern *pattern,
+		TickType_t now){
+	ch->pattern = pattern;
+	ch->index = 0;
+	ch->due = now;
+	if ((pattern != NULL) && (pattern->count > 0)){
+		ch->due = now + stepTicks(&pattern->steps[0]);
+	} else {
+		ch->pattern = NULL;
+	}
+}
+
+/***
+ * Ticks a step lasts
+ * @param step
+ * @return ticks, at least one
+ */
+TickType_t LEDPatternEngine::stepTicks(const LEDStep *step){
+	TickType_t ticks = pdMS_TO_TICKS(step->time * LED_PATTERN_UNIT_MS);
+	if (ticks == 0){
+		ticks = 1;
+	}
+	return ticks;
+}
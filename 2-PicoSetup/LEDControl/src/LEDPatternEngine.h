@@ -0,0 +1,156 @@
+/*
+ * LEDPatternEngine.h
+ *
+ * Drives a set of LED channels, each running a step table pattern,
+ * from a single task. On each wake the outputs of every channel that
+ * changes are applied together with one masked GPIO write. The task
+ * sleeps until the next step is due, or one tick while any channel is
+ * at a part level and so being soft PWMed.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _LEDPATTERNENGINE_H_
+#define _LEDPATTERNENGINE_H_
+
+#include "Agent.h"
+#include "queue.h"
+#include "LEDPatterns.h"
+
+//Max number of channels
+#ifndef LED_PATTERN_CHANNELS
+#define LED_PATTERN_CHANNELS 	8
+#endif
+
+//Pattern changes waiting to be applied
+#ifndef LED_PATTERN_QUEUE_LEN
+#define LED_PATTERN_QUEUE_LEN 	4
+#endif
+
+#ifndef LED_PATTERN_STACK
+#define LED_PATTERN_STACK 		200
+#endif
+
+class LEDPatternEngine : public Agent {
+public:
+	/***
+	 * Constructor
+	 */
+	LEDPatternEngine();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~LEDPatternEngine();
+
+	/***
+	 * Add a channel on a GPIO pad. Must be called before start
+	 * @param gp - GPIO pad number for LED
+	 * @param pattern - initial pattern, NULL for off
+	 * @return channel number or -1 if full
+	 */
+	int8_t add(uint8_t gp, const LEDPattern *pattern = NULL);
+
+	/***
+	 * Set the pattern for a channel, applied on the next wake.
+	 * Does not block
+	 * @param channel
+	 * @param pattern
+	 * @return false if the channel or pattern is invalid or queue is full
+	 */
+	bool setPattern(uint8_t channel, const LEDPattern *pattern);
+
+	/***
+	 * Set a built in pattern by name for a channel
+	 * @param channel
+	 * @param name - pattern name
+	 * @return false if the channel or name is invalid or queue is full
+	 */
+	bool setPattern(uint8_t channel, const char *name);
+
+	/***
+	 * Update all channels and write changed outputs
+	 * @return ticks until the next update is needed
+	 */
+	virtual TickType_t step();
+
+	/***
+	 * Number of channels
+	 * @return
+	 */
+	uint8_t getCount();
+
+	/***
+	 * Total time spent updating the channels
+	 * @return micro seconds
+	 */
+	uint64_t getBusyUs();
+
+	/***
+	 * Number of updates run
+	 * @return
+	 */
+	uint32_t getSteps();
+
+	/***
+	 * RAM used by the engine for each channel
+	 * @return bytes
+	 */
+	static size_t getChannelSize();
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	struct LEDChannel {
+		const LEDPattern *pattern;
+		TickType_t due;
+		uint8_t pad;
+		uint8_t index;
+	};
+
+	struct LEDPatternCmd {
+		uint8_t channel;
+		const LEDPattern *pattern;
+	};
+
+	/***
+	 * Start a channel at the first step of its pattern
+	 * @param ch - channel
+	 * @param pattern
+	 * @param now - current tick
+	 */
+	void begin(LEDChannel *ch, const LEDPattern *pattern, TickType_t now);
+
+	/***
+	 * Ticks a step lasts
+	 * @param step
+	 * @return ticks, at least one
+	 */
+	static TickType_t stepTicks(const LEDStep *step);
+
+	LEDChannel xChannels[LED_PATTERN_CHANNELS];
+	uint8_t xCount = 0;
+
+	//Current output of all channel pads
+	uint32_t xOut = 0;
+
+	QueueHandle_t xCmdQ = NULL;
+	uint8_t xCmdQStorage[ LED_PATTERN_QUEUE_LEN * sizeof(LEDPatternCmd) ];
+	StaticQueue_t xCmdQStruct;
+
+	uint64_t xBusyUs = 0;
+	uint32_t xSteps = 0;
+};
+
+#endif /* _LEDPATTERNENGINE_H_ */
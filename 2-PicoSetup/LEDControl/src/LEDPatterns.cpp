@@ -0,0 +1,86 @@
+/*
+ * LEDPatterns.cpp
+ *
+ * Built in LED patterns, each described as a compact table of steps.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "LEDPatterns.h"
+#include <cstring>
+
+#define FULL 	LED_PATTERN_LEVELS
+
+static const LEDStep xOff[] = {
+		{0, 100}
+};
+
+static const LEDStep xOn[] = {
+		{FULL, 100}
+};
+
+static const LEDStep xBlink[] = {
+		{FULL, 50}, {0, 50}
+};
+
+static const LEDStep xHeartbeat[] = {
+		{FULL, 10}, {0, 15}, {FULL, 10}, {0, 75}
+};
+
+static const LEDStep xFade[] = {
+		{0, 5}, {1, 5}, {2, 5}, {3, 5}, {4, 5}, {5, 5}, {6, 5}, {7, 5},
+		{FULL, 5}, {7, 5}, {6, 5}, {5, 5}, {4, 5}, {3, 5}, {2, 5}, {1, 5}
+};
+
+//Morse SOS, dot of 150ms
+static const LEDStep xSOS[] = {
+		{FULL, 15}, {0, 15}, {FULL, 15}, {0, 15}, {FULL, 15}, {0, 45},
+		{FULL, 45}, {0, 15}, {FULL, 45}, {0, 15}, {FULL, 45}, {0, 45},
+		{FULL, 15}, {0, 15}, {FULL, 15}, {0, 15}, {FULL, 15}, {0, 105}
+};
+
+#define PATTERN(n, s)	{n, s, sizeof(s) / sizeof(LEDStep)}
+
+static const LEDPattern xPatterns[] = {
+		PATTERN("off", xOff),
+		PATTERN("on", xOn),
+		PATTERN("blink", xBlink),
+		PATTERN("heartbeat", xHeartbeat),
+		PATTERN("fade", xFade),
+		PATTERN("sos", xSOS)
+};
+
+/***
+ * Find a built in pattern by name
+ * @param name - zero terminated name
+ * @return pattern or NULL if not found
+ */
+const LEDPattern *LEDPatterns::find(const char *name){
+	for (uint8_t i=0; i < count(); i++){
+		if (strcmp(xPatterns[i].name, name) == 0){
+			return &xPatterns[i];
+		}
+	}
+	return NULL;
+}
+
+/***
+ * Get built in pattern by index
+ * @param index
+ * @return pattern or NULL if out of range
+ */
+const LEDPattern *LEDPatterns::get(uint8_t index){
+	if (index >= count()){
+		return NULL;
+	}
+	return &xPatterns[index];
+}
+
+/***
+ * Number of built in patterns
+ * @return
+ */
+uint8_t LEDPatterns::count(){
+	return sizeof(xPatterns) / sizeof(LEDPattern);
+}
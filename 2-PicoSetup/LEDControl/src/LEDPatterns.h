@@ -0,0 +1,61 @@
+/*
+ * LEDPatterns.h
+ *
+ * Built in LED patterns, each described as a compact table of steps.
+ * A step holds a brightness level and how long it lasts in units of
+ * LED_PATTERN_UNIT_MS. A pattern repeats once its last step ends.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _LEDPATTERNS_H_
+#define _LEDPATTERNS_H_
+
+#include "pico/stdlib.h"
+
+//Duration of one step time unit in ms
+#ifndef LED_PATTERN_UNIT_MS
+#define LED_PATTERN_UNIT_MS 	10
+#endif
+
+//Level for fully on, levels in between are soft PWM
+#ifndef LED_PATTERN_LEVELS
+#define LED_PATTERN_LEVELS 		8
+#endif
+
+struct LEDStep {
+	uint8_t level;
+	uint8_t time;
+};
+
+struct LEDPattern {
+	const char *name;
+	const LEDStep *steps;
+	uint8_t count;
+};
+
+class LEDPatterns {
+public:
+	/***
+	 * Find a built in pattern by name
+	 * @param name - zero terminated name
+	 * @return pattern or NULL if not found
+	 */
+	static const LEDPattern *find(const char *name);
+
+	/***
+	 * Get built in pattern by index
+	 * @param index
+	 * @return pattern or NULL if out of range
+	 */
+	static const LEDPattern *get(uint8_t index);
+
+	/***
+	 * Number of built in patterns
+	 * @return
+	 */
+	static uint8_t count();
+};
+
+#endif /* _LEDPATTERNS_H_ */
@@ -13,9 +13,13 @@
 
 #define LED_TOPIC  "LED/req"
 #define PAYLOAD_ON "on"
+#define PAYLOAD_PATTERN "pattern"
+#define PAYLOAD_CHANNEL "ch"
 
-MQTTRouterLED::MQTTRouterLED(char * id, uint8_t gp) {
-	xLedPad = gp;
+MQTTRouterLED::MQTTRouterLED(char * id, LEDPatternEngine *engine,
+		uint8_t channel) {
+	pEngine = engine;
+	xChannel = channel;
 	init(id);
 }
 
@@ -24,13 +28,9 @@ MQTTRouterLED::~MQTTRouterLED() {
 }
 
 /***
- * Initialise the GPIO pad for LED
+ * Initialise the topic
  */
 void MQTTRouterLED::init(char * id){
-	gpio_init(xLedPad);
-	gpio_set_dir(xLedPad, GPIO_OUT);
-	gpio_put(xLedPad, 1);
-
 	if (pLedTopic == NULL){
 		pLedTopic = (char *)pvPortMalloc(
 				MQTTTopicHelper::lenThingTopic(id, LED_TOPIC)
@@ -55,7 +55,9 @@ void MQTTRouterLED::subscribe(MQTTInterface *interface){
 }
 
 /***
- * Route the message the appropriate part of the application
+ * Route the message the appropriate part of the application.
+ * Payload is {"on": bool} or {"pattern": name} with an optional
+ * "ch" to select the engine channel
  * @param topic
  * @param topicLen
  * @param payload
@@ -81,13 +83,26 @@ void MQTTRouterLED::route(const char *topic,
 	 return ;
 	}
 
+	uint8_t channel = xChannel;
+	json_t const* ch = json_getProperty( json, PAYLOAD_CHANNEL );
+	if ( ch && JSON_INTEGER == json_getType( ch ) ) {
+		channel = (uint8_t)json_getInteger(ch);
+	}
+
+	const char *name = NULL;
+	json_t const* pattern = json_getProperty( json, PAYLOAD_PATTERN );
 	json_t const* on = json_getProperty( json, PAYLOAD_ON );
-	if ( !on || JSON_BOOLEAN != json_getType( on ) ) {
-	 LogError(("Error, the property is not found."));
-	 return ;
+	if ( pattern && JSON_TEXT == json_getType( pattern ) ) {
+		name = json_getValue(pattern);
+	} else if ( on && JSON_BOOLEAN == json_getType( on ) ) {
+		name = json_getBoolean(on) ? "on" : "off";
+	} else {
+		LogError(("Error, the property is not found."));
+		return ;
 	}
-	bool  b = json_getBoolean(on);
 
-	gpio_put(xLedPad, b);
+	if (!pEngine->setPattern(channel, name)){
+		LogError(("Unable to set pattern %s on channel %d", name, channel));
+	}
 
 }
@@ -12,19 +12,21 @@
 #define _MQTTROUTERLED_H_
 
 #include "tiny-json.h"
+#include "LEDPatternEngine.h"
 
 
-#define LED_JSON_POOL  4
-#define LED_BUFFER    20
+#define LED_JSON_POOL  6
+#define LED_BUFFER    48
 
 class MQTTRouterLED : public MQTTRouter{
 public:
 	/***
 	 * Constructor
 	 * @param id - ID of the device, used to build the topic
-	 * @param gp - GPIO PAD number for the LED to control
+	 * @param engine - pattern engine driving the LEDs
+	 * @param channel - default engine channel to control
 	 */
-	MQTTRouterLED(char *id, uint8_t gp);
+	MQTTRouterLED(char *id, LEDPatternEngine *engine, uint8_t channel);
 	virtual ~MQTTRouterLED();
 
 	/***
@@ -48,11 +50,12 @@ public:
 
 private:
 	/***
-	 * Initialise the GPIO pad for LED
+	 * Initialise the topic
 	 */
 	void init(char * id);
 
-	uint8_t xLedPad;
+	LEDPatternEngine *pEngine = NULL;
+	uint8_t xChannel;
 	char *pLedTopic = NULL;
 
 	// Temporaty storage buffer so we can null terminate the string
@@ -5,8 +5,8 @@
  *
  * Control an LED over MQTT using Topic
  * TNG/<<device>>/TPC/LED
- * with JSON payload as boolean state
- * e.g. {"on": True}
+ * with JSON payload as boolean state or pattern name
+ * e.g. {"on": True} or {"pattern": "heartbeat", "ch": 0}
  *
  */
 
@@ -26,7 +26,7 @@
 
 #include "MQTTAgent.h"
 #include <WifiHelper.h>
-#include "BlinkAgent.h"
+#include "LEDPatternEngine.h"
 #include "MQTTRouterLED.h"
 
 //Check these definitions where added from the makefile
@@ -122,9 +122,16 @@ void main_task(void *params){
 
 	printf("Main task started\n");
 
-	//Start up pulse blink LED
-	BlinkAgent blink(PULSE_LED);
-	blink.start("Blink", TASK_PRIORITY);
+	//All LEDs are driven by the one pattern engine task
+	static LEDPatternEngine leds;
+	leds.add(PULSE_LED, LEDPatterns::find("heartbeat"));
+	int8_t controlCh = leds.add(CONTROL_LED, LEDPatterns::find("on"));
+	leds.start("LEDs", TASK_PRIORITY);
+
+	printf("Pattern channel RAM %lu bytes, a task per LED at least %lu bytes\n",
+			(unsigned long)LEDPatternEngine::getChannelSize(),
+			(unsigned long)(sizeof(StaticTask_t) +
+				configMINIMAL_STACK_SIZE * sizeof(StackType_t)));
 
 
 	// Init Wifi Adapter
@@ -163,7 +170,7 @@ void main_task(void *params){
 	char mqttClient[] = MQTT_CLIENT;
 	char mqttUser[] = MQTT_USER;
 	char mqttPwd[] = MQTT_PASSWD;
-	MQTTRouterLED mqttRouter(mqttClient, CONTROL_LED);
+	MQTTRouterLED mqttRouter(mqttClient, &leds, controlCh);
 	MQTTAgent mqttAgent;
 
 
@@ -179,10 +186,18 @@ void main_task(void *params){
 
 
 
+	uint64_t lastBusy = 0;
     while(true) {
 
     	runTimeStats();
 
+    	uint64_t busy = leds.getBusyUs();
+    	printf("Pattern engine %d channels, %lu us CPU per channel over 3s, %lu steps\n",
+    			leds.getCount(),
+    			(unsigned long)((busy - lastBusy) / leds.getCount()),
+    			(unsigned long)leds.getSteps());
+    	lastBusy = busy;
+
         vTaskDelay(3000);
 
 
@@ -101,6 +101,8 @@ void LEDAgent::setOn(bool on){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -113,6 +115,8 @@ void LEDAgent::toggle(){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -124,6 +128,8 @@ void LEDAgent::intToggle(){
 	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wakeFromISR();
 	}
 }
 
@@ -132,7 +138,6 @@ void LEDAgent::intToggle(){
   * Main Run Task for agent
   */
 void LEDAgent::run(){
-	BaseType_t res;
 
 	LEDAction action = LEDOff;
 
@@ -141,8 +146,7 @@ void LEDAgent::run(){
 	}
 
 	while (true) { // Loop forever
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
+		while (xQueueReceive(xCmdQ, (void *)&action, 0) == pdTRUE){
 			switch(action){
 				case LEDOff:{
 					execLed(false);
@@ -157,8 +161,10 @@ void LEDAgent::run(){
 					break;
 				}
 			}
-			taskYIELD();
 		}
+
+		//Sleep until more work is queued
+		waitForWork();
 	}
 }
 
@@ -110,6 +110,8 @@ void LEDAgent::setOn(bool on){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -122,6 +124,8 @@ void LEDAgent::toggle(){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -133,6 +137,8 @@ void LEDAgent::intToggle(){
 	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wakeFromISR();
 	}
 }
 
@@ -141,9 +147,8 @@ void LEDAgent::intToggle(){
   * Main Run Task for agent
   */
 void LEDAgent::run(){
-	BaseType_t res;
 	LEDAction action = LEDOff;
-	char jsonStr[LED_JSON_LEN];
+	char jsonStr[LED_JSON_LEN + 1];
 	size_t readLen;
 
 	if (xCmdQ == NULL){
@@ -151,19 +156,12 @@ void LEDAgent::run(){
 	}
 
 	while (true) { // Loop forever
-		readLen = xMessageBufferReceive(
-						 xBuffer,
-				         jsonStr,
-						 LED_JSON_LEN,
-						 0
-				    );
-		if (readLen > 0){
+		while ((readLen = xMessageBufferReceive(xBuffer, jsonStr, LED_JSON_LEN, 0)) > 0){
 			jsonStr[readLen] = 0;
 	        parseJSON(jsonStr);
 		}
 
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
+		while (xQueueReceive(xCmdQ, (void *)&action, 0) == pdTRUE){
 			switch(action){
 				case LEDOff:{
 					execLed(false);
@@ -178,8 +176,10 @@ void LEDAgent::run(){
 					break;
 				}
 			}
-			taskYIELD();
 		}
+
+		//Sleep until more work is queued
+		waitForWork();
 	}
 }
 
@@ -249,6 +249,11 @@ void LEDAgent::parseJSON(char *str){
  * @param jsonStr
  */
 void LEDAgent::addJSON(const void  *jsonStr, size_t len){
+	//Larger message would never fit the run loop's buffer and block the rest
+	if (len > LED_JSON_LEN){
+		LogWarn(("JSON too long, %u bytes dropped\n", (unsigned int)len));
+		return;
+	}
 	if (xBuffer != NULL){
 		size_t res = xMessageBufferSend(
 			xBuffer,
@@ -258,6 +263,8 @@ void LEDAgent::addJSON(const void  *jsonStr, size_t len){
 
 		if (res != len){
 			LogError(("Failed to write"));
+		} else {
+			wake();
 		}
 	}
 }
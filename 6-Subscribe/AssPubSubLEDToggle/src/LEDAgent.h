@@ -25,7 +25,10 @@
 #define LED_QUEUE_LEN 	5
 #define MQTT_TOPIC_LED_STATE "LED/state"
 #define LED_BUFFER_LEN 	256
-#define LED_JSON_LEN 	20
+//Longest JSON command accepted by addJSON
+#ifndef LED_JSON_LEN
+#define LED_JSON_LEN 	64
+#endif
 #define LED_JSON_POOL 	5
 
 
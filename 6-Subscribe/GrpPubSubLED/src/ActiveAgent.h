@@ -0,0 +1,131 @@
+/*
+ * ActiveAgent.h
+ *
+ * Active object on top of Agent. The task owns one bounded, statically
+ * allocated queue of typed events. Commands from other tasks and
+ * interrupts are posted as events and handled one at a time by
+ * dispatch, which runs on the agent's own task.
+ *
+ * E is normally a small tagged union, it is copied into the queue so
+ * must be trivially copyable.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _ACTIVEAGENT_H_
+#define _ACTIVEAGENT_H_
+
+#include "Agent.h"
+#include "queue.h"
+#include <type_traits>
+
+template<class E, UBaseType_t N>
+class ActiveAgent : public Agent {
+	static_assert(std::is_trivially_copyable<E>::value,
+			"Events are copied into a FreeRTOS queue");
+public:
+	/***
+	 * Constructor
+	 */
+	ActiveAgent() {
+		xEventQ = xQueueCreateStatic(N, sizeof(E), xEventQStorage, &xEventQStruct);
+	}
+
+	/***
+	 * Destructor
+	 */
+	virtual ~ActiveAgent() {
+		stop();
+	}
+
+	/***
+	 * Post an event to the back of the queue. Does not block
+	 * @param e - event
+	 * @return false if the queue is full
+	 */
+	bool post(const E &e) {
+		if (xQueueSendToBack(xEventQ, (void *)&e, 0) != pdTRUE){
+			xOverflows++;
+			return false;
+		}
+		UBaseType_t depth = uxQueueMessagesWaiting(xEventQ);
+		if (depth > xMaxDepth){
+			xMaxDepth = depth;
+		}
+		return true;
+	}
+
+	/***
+	 * Post an event from within an interrupt. Goes to the front of the
+	 * queue so it is handled ahead of any backlog
+	 * @param e - event
+	 * @return false if the queue is full
+	 */
+	bool postFromISR(const E &e) {
+		BaseType_t woken = pdFALSE;
+		if (xQueueSendToFrontFromISR(xEventQ, (void *)&e, &woken) != pdTRUE){
+			xOverflows++;
+			return false;
+		}
+		UBaseType_t depth = uxQueueMessagesWaitingFromISR(xEventQ);
+		if (depth > xMaxDepth){
+			xMaxDepth = depth;
+		}
+		portYIELD_FROM_ISR(woken);
+		return true;
+	}
+
+	/***
+	 * Number of events lost because the queue was full
+	 * @return
+	 */
+	uint32_t getOverflows() {
+		return xOverflows;
+	}
+
+	/***
+	 * Number of events waiting to be handled
+	 * @return
+	 */
+	UBaseType_t getQueueDepth() {
+		return uxQueueMessagesWaiting(xEventQ);
+	}
+
+	/***
+	 * Most events that have been waiting at once, out of N
+	 * @return
+	 */
+	UBaseType_t getMaxQueueDepth() {
+		return xMaxDepth;
+	}
+
+protected:
+	/***
+	 * Task main run loop, blocks until an event arrives
+	 */
+	virtual void run() {
+		E e;
+		while (true) { // Loop forever
+			if (xQueueReceive(xEventQ, (void *)&e, portMAX_DELAY) == pdTRUE){
+				dispatch(e);
+			}
+		}
+	}
+
+	/***
+	 * Handle a single event on the agent's task
+	 * @param e - event
+	 */
+	virtual void dispatch(const E &e) = 0;
+
+private:
+	QueueHandle_t xEventQ = NULL;
+	uint8_t xEventQStorage[ N * sizeof(E) ];
+	StaticQueue_t xEventQStruct;
+
+	volatile uint32_t xOverflows = 0;
+	volatile UBaseType_t xMaxDepth = 0;
+};
+
+#endif /* _ACTIVEAGENT_H_ */
@@ -11,9 +11,6 @@
 #include "MQTTTopicHelper.h"
 #include "json-maker/json-maker.h"
 
-//Local enumerator of the actions to be queued
-enum LEDAction {LEDOff, LEDOn, LEDGrpOn, LEDGrpOff, LEDToggle};
-
 /***
  * Constructor
  * @param ledGP - GPIO Pad of LED to control
@@ -34,22 +31,6 @@ LEDAgent::LEDAgent(uint8_t ledGP, uint8_t spstGP, MQTTInterface *interface) {
 	pSwitchMgr = new SwitchMgr(xSpstGP);
 	pSwitchMgr->setObserver(this);
 
-	// Queue for actions commands for the class
-	xCmdQ = xQueueCreate( LED_QUEUE_LEN, sizeof(LEDAction));
-	if (xCmdQ == NULL){
-		LogError(("Unable to create Queue\n"));
-	}
-
-	//Construct a message buffer
-	xBuffer = xMessageBufferCreate(LED_BUFFER_LEN);
-	if (xBuffer == NULL){
-		LogError(("Buffer could not be allocated\n"));
-	}
-	xGrpBuffer = xMessageBufferCreate(LED_BUFFER_LEN);
-	if (xGrpBuffer == NULL){
-		LogError(("Grp Buffer could not be allocated\n"));
-	}
-
 	//Construct the TOPIC for status messages
 	if (pInterface != NULL){
 		pTopicLedState = (char *)pvPortMalloc( MQTTTopicHelper::lenThingTopic(pInterface->getId(), MQTT_TOPIC_LED_STATE));
@@ -76,19 +57,10 @@ LEDAgent::~LEDAgent() {
 	if (pSwitchMgr != NULL){
 		delete pSwitchMgr;
 	}
-	if (xCmdQ != NULL){
-		vQueueDelete(xCmdQ);
-	}
 	if (pTopicLedState != NULL){
 		vPortFree(pTopicLedState);
 		pTopicLedState = NULL;
 	}
-	if (xBuffer != NULL){
-		vMessageBufferDelete(xBuffer);
-	}
-	if (xGrpBuffer != NULL){
-		vMessageBufferDelete(xGrpBuffer);
-	}
 }
 
 
@@ -112,24 +84,15 @@ void LEDAgent::handleLongPress(uint8_t gp){
 /***
  * Set the states of the LED to - on
  * @param on - boolean if the LED should be on or off
+ * @param grp - request is to group, if so don't notify group
  */
 void LEDAgent::setOn(bool on, bool grp){
-	LEDAction action = LEDOff;
+	LEDEvent e;
+	e.type = LEDEvtSet;
+	e.set.on = on;
+	e.set.grp = grp;
 
-	if (grp){
-		if (on){
-			action = LEDGrpOn;
-		}else {
-			action = LEDGrpOff;
-		}
-	} else {
-		if (on){
-			action = LEDOn;
-		}
-	}
-
-	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
-	if (res != pdTRUE){
+	if (!post(e)){
 		LogWarn(("Queue is full\n"));
 	}
 }
@@ -139,9 +102,23 @@ void LEDAgent::setOn(bool on, bool grp){
  * Toggle the state of the LED. so On becomes Off, etc.
  */
 void LEDAgent::toggle(){
-	LEDAction action = LEDToggle;
-	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
-	if (res != pdTRUE){
+	LEDEvent e;
+	e.type = LEDEvtToggle;
+
+	if (!post(e)){
+		LogWarn(("Queue is full\n"));
+	}
+}
+
+/***
+ * Publish the current state of the LED without changing it,
+ * such as after the MQTT connection is made
+ */
+void LEDAgent::notifyState(){
+	LEDEvent e;
+	e.type = LEDEvtNotify;
+
+	if (!post(e)){
 		LogWarn(("Queue is full\n"));
 	}
 }
@@ -150,77 +127,32 @@ void LEDAgent::toggle(){
  * Toggle LED state from within an intrupt
  */
 void LEDAgent::intToggle(){
-	LEDAction action = LEDToggle;
-	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
-	if (res != pdTRUE){
+	LEDEvent e;
+	e.type = LEDEvtToggle;
+
+	if (!postFromISR(e)){
 		LogWarn(("Queue is full\n"));
 	}
 }
 
 
 /***
-  * Main Run Task for agent
-  */
-void LEDAgent::run(){
-	BaseType_t res;
-	LEDAction action = LEDOff;
-	char jsonStr[LED_JSON_LEN];
-	size_t readLen;
-
-	if (xCmdQ == NULL){
-		return;
-	}
-
-	while (true) { // Loop forever
-		//Read device topic buffer
-		readLen = xMessageBufferReceive(
-						 xBuffer,
-				         jsonStr,
-						 LED_JSON_LEN,
-						 0
-				    );
-		if (readLen > 0){
-			jsonStr[readLen] = 0;
-	        parseJSON(jsonStr);
+ * Handle a single event on the agent's task
+ * @param e - event
+ */
+void LEDAgent::dispatch(const LEDEvent &e){
+	switch(e.type){
+		case LEDEvtSet:{
+			execLed(e.set.on, e.set.grp);
+			break;
 		}
-
-		//Read group topic buffer
-		readLen = xMessageBufferReceive(
-						 xGrpBuffer,
-						 jsonStr,
-						 LED_JSON_LEN,
-						 0
-					);
-		if (readLen > 0){
-			jsonStr[readLen] = 0;
-			parseGrpJSON(jsonStr);
+		case LEDEvtToggle:{
+			execLed(!xState);
+			break;
 		}
-
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
-			switch(action){
-				case LEDOff:{
-					execLed(false);
-					break;
-				}
-				case LEDOn:{
-					execLed(true);
-					break;
-				}
-				case LEDGrpOff:{
-					execLed(false, true);
-					break;
-				}
-				case LEDGrpOn:{
-					execLed(true, true);
-					break;
-				}
-				case LEDToggle:{
-					execLed(!xState);
-					break;
-				}
-			}
-			taskYIELD();
+		case LEDEvtNotify:{
+			publishState();
+			break;
 		}
 	}
 }
@@ -234,28 +166,14 @@ void LEDAgent::execLed(bool state, bool grp){
 	xState = state;
 	gpio_put(xLedGP, xState);
 
-	char payload[LED_JSON_LEN];
-
 	// Send to device pub topic
-	char *json = payload;
-	size_t remLen = LED_JSON_LEN;
-	json = json_objOpen(json, NULL, &remLen);
-	json = json_bool(json, "on", xState, &remLen);
-	json = json_objClose( json, &remLen);
-	if (pInterface != NULL){
-		pInterface->pubToTopic(
-			pTopicLedState,
-			payload,
-			strlen(payload),
-			1,
-			false
-			);
-	}
+	publishState();
 
 	// Send to group topic
 	if (!grp){
-		json = payload;
-		remLen = LED_JSON_LEN;
+		char payload[LED_JSON_LEN];
+		char *json = payload;
+		size_t remLen = LED_JSON_LEN;
 		json = json_objOpen(json, NULL, &remLen);
 		json = json_str(json, "source", pInterface->getId(), &remLen);
 		json = json_bool(json, "on", xState, &remLen);
@@ -274,12 +192,35 @@ void LEDAgent::execLed(bool state, bool grp){
 
 
 
+/***
+ * Publish the state of the LED on the device topic
+ */
+void LEDAgent::publishState(){
+	char payload[LED_JSON_LEN];
+	char *json = payload;
+	size_t remLen = LED_JSON_LEN;
+
+	json = json_objOpen(json, NULL, &remLen);
+	json = json_bool(json, "on", xState, &remLen);
+	json = json_objClose( json, &remLen);
+	if (pInterface != NULL){
+		pInterface->pubToTopic(
+			pTopicLedState,
+			payload,
+			strlen(payload),
+			1,
+			false
+			);
+	}
+}
+
+
 /***
  * Get the static depth required in words
  * @return - words
  */
  configSTACK_DEPTH_TYPE LEDAgent::getMaxStackSize(){
-	 return 512;
+	 return LED_AGENT_STACK;
  }
 
 
@@ -305,40 +246,34 @@ void LEDAgent::parseJSON(char *str){
 
 
 /***
- * Add a JSON string action
+ * Add a JSON string action. Parsed on the calling task and
+ * posted as a command event
  * @param jsonStr
  */
 void LEDAgent::addJSON(const void  *jsonStr, size_t len){
-	if (xBuffer != NULL){
-		size_t res = xMessageBufferSend(
-			xBuffer,
-			jsonStr,
-			len,
-			0);
-
-		if (res != len){
-			LogError(("Failed to write"));
-		}
+	if (len > LED_JSON_LEN){
+		LogError(("JSON too long %d", len));
+		return;
 	}
+	memcpy(xJsonStr, jsonStr, len);
+	xJsonStr[len] = 0;
+	parseJSON(xJsonStr);
 }
 
 
 /***
- * Add a JSON string from group topic
+ * Add a JSON string from group topic. Parsed on the calling task and
+ * posted as a command event
  * @param jsonStr
  */
 void LEDAgent::addGrpJSON(const void  *jsonStr, size_t len){
-	if (xGrpBuffer != NULL){
-		size_t res = xMessageBufferSend(
-			xGrpBuffer,
-			jsonStr,
-			len,
-			0);
-
-		if (res != len){
-			LogError(("Failed to write"));
-		}
+	if (len > LED_JSON_LEN){
+		LogError(("JSON too long %d", len));
+		return;
 	}
+	memcpy(xJsonStr, jsonStr, len);
+	xJsonStr[len] = 0;
+	parseGrpJSON(xJsonStr);
 }
 
 /***
@@ -11,14 +11,12 @@
 #define _LEDAGENT_H_
 
 
-#include "Agent.h"
+#include "ActiveAgent.h"
 #include "SwitchObserver.h"
 #include "SwitchMgr.h"
 #include "tiny-json.h"
 
 #include "pico/stdlib.h"
-#include "queue.h"
-#include "message_buffer.h"
 #include "MQTTConfig.h"
 #include "MQTTInterface.h"
 
@@ -26,12 +24,31 @@
 #define MQTT_TOPIC_LED_STATE 	"LED/state"
 #define MQTT_TOPIC_LED_GRP		"LED"
 #define MQTT_TOPIC_LED_GRP_REQ 	"req"
-#define LED_BUFFER_LEN 	256
 #define LED_JSON_LEN 	120
 #define LED_JSON_POOL 	5
 
+//Stack in words, the task only dispatches events and publishes state
+#ifndef LED_AGENT_STACK
+#define LED_AGENT_STACK 	300
+#endif
+
+//Event types handled by the LED agent
+enum LEDEventType {LEDEvtSet, LEDEvtToggle, LEDEvtNotify};
+
+//Event posted to the LED agent, type selects the member of the union.
+//LEDEvtToggle and LEDEvtNotify carry no data
+struct LEDEvent {
+	LEDEventType type;
+	union {
+		//LEDEvtSet
+		struct {
+			bool on;
+			bool grp;
+		} set;
+	};
+};
 
-class LEDAgent : public Agent, public SwitchObserver {
+class LEDAgent : public ActiveAgent<LEDEvent, LED_QUEUE_LEN>, public SwitchObserver {
 public:
 	/***
 	 * Constructor
@@ -58,15 +75,25 @@ public:
 	 */
 	void toggle();
 
+	/***
+	 * Publish the current state of the LED without changing it,
+	 * such as after the MQTT connection is made
+	 */
+	void notifyState();
+
 
 	/***
-	 * Add a JSON string from device topic
+	 * Add a JSON string from device topic. Parsed on the calling
+	 * task and posted as a command event. Only call from the one task
+	 * routing MQTT messages, as the parse buffers are shared
 	 * @param jsonStr
 	 */
 	void addJSON(const void  *jsonStr, size_t len);
 
 	/***
-	 * Add a JSON string from group topic
+	 * Add a JSON string from group topic. Parsed on the calling
+	 * task and posted as a command event. Only call from the one task
+	 * routing MQTT messages, as the parse buffers are shared
 	 * @param jsonStr
 	 */
 	void addGrpJSON(const void  *jsonStr, size_t len);
@@ -92,9 +119,10 @@ public:
 
 protected:
 	/***
-	 * Task main run loop
+	 * Handle a single event on the agent's task
+	 * @param e - event
 	 */
-	virtual void run();
+	virtual void dispatch(const LEDEvent &e);
 
 	/***
 	 * Get the static depth required in words
@@ -115,6 +143,11 @@ private:
 	 */
 	void execLed(bool state, bool grp = false);
 
+	/***
+	 * Publish the state of the LED on the device topic
+	 */
+	void publishState();
+
 	/***
 	 * Parse a JSON string and add request to queue
 	 * JSON from device topic
@@ -146,15 +179,9 @@ private:
 	// Switch manage to manage the SPST switch
 	SwitchMgr *pSwitchMgr = NULL;
 
-
-	//Queue of commands
-	QueueHandle_t xCmdQ;
-
-	// Message buffer handle
-	MessageBufferHandle_t xBuffer = NULL;
-	MessageBufferHandle_t xGrpBuffer = NULL;
-
-	// Json decoding buffer
+	//JSON being parsed and its decoding buffer. Used by the MQTT task
+	//in addJSON and addGrpJSON, kept here rather than on its stack
+	char xJsonStr[LED_JSON_LEN + 1];
 	json_t pJsonPool[ LED_JSON_POOL ];
 
 };
@@ -41,6 +41,11 @@ void MQTTRouterLED::subscribe(MQTTInterface *interface){
 	if (pLedTopic != NULL){
 		interface->subToTopic(pLedTopic, 1);
 	}
+
+	//Publish the current state now we are connected
+	if (pAgent != NULL){
+		pAgent->notifyState();
+	}
 }
 
 /***
@@ -175,6 +175,12 @@ void main_task(void *params){
     while(true) {
 
     	runTimeStats();
+    	//LED agent only runs when its event queue has work
+    	printf("LEDAgent queue %lu, max %lu of %lu, overflows %lu\n",
+    			(unsigned long)ledAgent.getQueueDepth(),
+    			(unsigned long)ledAgent.getMaxQueueDepth(),
+    			(unsigned long)LED_QUEUE_LEN,
+    			(unsigned long)ledAgent.getOverflows());
 
         vTaskDelay(3000);
 
@@ -0,0 +1,331 @@
+/*
+ * ActuatorBankAgent.cpp
+ *
+ * Manage a bank of output pads, such as relays and LEDs, as one agent.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "ActuatorBankAgent.h"
+#include "MQTTTopicHelper.h"
+
+/***
+ * Constructor
+ * @param pads - GPIO pads of the outputs, channel 0 first
+ * @param count - number of pads (up to ACT_BANK_MAX)
+ * @param interface - MQTT Interface that state will be notified to
+ */
+ActuatorBankAgent::ActuatorBankAgent(const uint8_t *pads, uint8_t count,
+		MQTTInterface *interface) {
+	pInterface = interface;
+
+	xCount = count;
+	if (xCount > ACT_BANK_MAX){
+		LogWarn(("Bank limited to %d channels\n", ACT_BANK_MAX));
+		xCount = ACT_BANK_MAX;
+	}
+	for (uint8_t i=0; i < xCount; i++){
+		xPads[i] = pads[i];
+		xAll |= (1 << i);
+	}
+
+	//Initialise all the outputs off together
+	uint32_t gpMask = padMask(xAll);
+	gpio_init_mask(gpMask);
+	gpio_set_dir_out_masked(gpMask);
+	gpio_put_masked(gpMask, 0);
+
+	for (uint8_t i=0; i < ACT_BANK_SWITCHES; i++){
+		pSwitchMgrs[i] = NULL;
+		xSwitchPads[i] = 0;
+		xSwitchChannels[i] = 0;
+	}
+
+	// Queue for actions commands for the class
+	xCmdQ = xQueueCreate( ACT_QUEUE_LEN, sizeof(ActuatorCmd));
+	if (xCmdQ == NULL){
+		LogError(("Unable to create Queue\n"));
+	}
+
+	//Construct a message buffer
+	xBuffer = xMessageBufferCreate(ACT_BUFFER_LEN);
+	if (xBuffer == NULL){
+		LogError(("Buffer could not be allocated\n"));
+	}
+
+	//Construct the TOPIC for status messages
+	if (pInterface != NULL){
+		pTopicActState = (char *)pvPortMalloc( MQTTTopicHelper::lenThingTopic(pInterface->getId(), MQTT_TOPIC_ACT_STATE));
+		if (pTopicActState != NULL){
+			MQTTTopicHelper::genThingTopic(pTopicActState, pInterface->getId(), MQTT_TOPIC_ACT_STATE);
+		} else {
+			LogError( ("Unable to allocate topic") );
+		}
+	}
+}
+
+/***
+ * Destructor
+ */
+ActuatorBankAgent::~ActuatorBankAgent() {
+	for (uint8_t i=0; i < xNumSwitches; i++){
+		delete pSwitchMgrs[i];
+		pSwitchMgrs[i] = NULL;
+	}
+	if (xCmdQ != NULL){
+		vQueueDelete(xCmdQ);
+	}
+	if (pTopicActState != NULL){
+		vPortFree(pTopicActState);
+		pTopicActState = NULL;
+	}
+	if (xBuffer != NULL){
+		vMessageBufferDelete(xBuffer);
+	}
+}
+
+/***
+ * Attach a SPST non latched switch that toggles channels
+ * @param spstGP - GPIO pad of the switch
+ * @param channels - bitmask of channels to toggle on a press
+ * @return false if no more switches can be attached
+ */
+bool ActuatorBankAgent::addSwitch(uint8_t spstGP, uint16_t channels){
+	if (xNumSwitches >= ACT_BANK_SWITCHES){
+		return false;
+	}
+	SwitchMgr *mgr = new SwitchMgr(spstGP);
+	mgr->setObserver(this);
+	pSwitchMgrs[xNumSwitches] = mgr;
+	xSwitchPads[xNumSwitches] = spstGP;
+	xSwitchChannels[xNumSwitches] = channels & xAll;
+	xNumSwitches++;
+	return true;
+}
+
+/***
+ * Handle a short press from a switch
+ * @param gp - GPIO number of the switch
+ */
+void ActuatorBankAgent::handleShortPress(uint8_t gp){
+	for (uint8_t i=0; i < xNumSwitches; i++){
+		if (xSwitchPads[i] == gp){
+			toggle(xSwitchChannels[i]);
+		}
+	}
+}
+
+/***
+ * Handle a long press from a switch
+ * @param gp - GPIO number of the switch
+ */
+void ActuatorBankAgent::handleLongPress(uint8_t gp){
+	handleShortPress(gp);
+}
+
+/***
+ * Set channels in mask to the matching bits of state
+ * @param mask - channels to change
+ * @param state - new state for those channels
+ */
+void ActuatorBankAgent::set(uint16_t mask, uint16_t state){
+	ActuatorCmd cmd = {mask, state, 0};
+	post(&cmd);
+}
+
+/***
+ * Toggle the channels in mask
+ * @param mask - channels to toggle
+ */
+void ActuatorBankAgent::toggle(uint16_t mask){
+	ActuatorCmd cmd = {0, 0, mask};
+	post(&cmd);
+}
+
+/***
+ * Queue a command
+ * @param cmd
+ */
+void ActuatorBankAgent::post(const ActuatorCmd *cmd){
+	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)cmd, 0);
+	if (res != pdTRUE){
+		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
+	}
+}
+
+/***
+ * Current state of all channels
+ * @return bitmask
+ */
+uint16_t ActuatorBankAgent::getState(){
+	return xState;
+}
+
+/***
+ * Number of batches applied
+ * @return
+ */
+uint32_t ActuatorBankAgent::getBatches(){
+	return xBatches;
+}
+
+/***
+ * Number of commands applied
+ * @return
+ */
+uint32_t ActuatorBankAgent::getCmds(){
+	return xCmds;
+}
+
+/***
+  * Main Run Task for agent
+  */
+void ActuatorBankAgent::run(){
+	ActuatorCmd cmd;
+	char jsonStr[ACT_JSON_LEN];
+	size_t readLen;
+
+	if (xCmdQ == NULL){
+		return;
+	}
+
+	while (true) { // Loop forever
+		while ((readLen = xMessageBufferReceive(xBuffer, jsonStr, ACT_JSON_LEN - 1, 0)) > 0){
+			jsonStr[readLen] = 0;
+			parseJSON(jsonStr);
+		}
+
+		//Fold everything queued into one new state
+		uint16_t state = xState;
+		bool pending = false;
+		while (xQueueReceive(xCmdQ, (void *)&cmd, 0) == pdTRUE){
+			state = (state & ~cmd.mask) | (cmd.state & cmd.mask);
+			state ^= cmd.toggle;
+			xCmds++;
+			pending = true;
+		}
+		if (pending){
+			execBatch(state & xAll);
+		}
+
+		//Sleep until more work is queued
+		waitForWork();
+	}
+}
+
+/***
+ * Write the channels to their pads and publish the state
+ * @param state - new state of all channels
+ */
+void ActuatorBankAgent::execBatch(uint16_t state){
+	uint16_t changed = state ^ xState;
+	if (changed == 0){
+		return;
+	}
+
+	xState = state;
+	gpio_put_masked(padMask(changed), padMask(state & changed));
+	xBatches++;
+
+	char payload[48];
+	sprintf(payload, "{\"state\":%u,\"changed\":%u}", xState, changed);
+	if ((pInterface != NULL) && (pTopicActState != NULL)){
+		pInterface->pubToTopic(
+			pTopicActState,
+			payload,
+			strlen(payload),
+			1,
+			false
+			);
+	}
+}
+
+/***
+ * Convert a channel bitmask to a GPIO pad bitmask
+ * @param channels
+ * @return GPIO mask
+ */
+uint32_t ActuatorBankAgent::padMask(uint16_t channels){
+	uint32_t mask = 0;
+	for (uint8_t i=0; i < xCount; i++){
+		if ((channels & (1 << i)) != 0){
+			mask |= (1UL << xPads[i]);
+		}
+	}
+	return mask;
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE ActuatorBankAgent::getMaxStackSize(){
+	return 300;
+}
+
+/***
+* Parse a JSON string and queue the command
+* @param str - JSON String
+*/
+void ActuatorBankAgent::parseJSON(char *str){
+	ActuatorCmd cmd = {0, 0, 0};
+
+	json_t const* json = json_create( str, pJsonPool, ACT_JSON_POOL);
+	if ( !json ) {
+		LogError(("Error json create."));
+		return ;
+	}
+
+	json_t const* mask = json_getProperty( json, "mask" );
+	json_t const* state = json_getProperty( json, "state" );
+	json_t const* tog = json_getProperty( json, "toggle" );
+
+	if ( mask && JSON_INTEGER == json_getType( mask ) ) {
+		if ( !state || JSON_INTEGER != json_getType( state ) ) {
+			LogError(("Error, mask without state."));
+			return ;
+		}
+		cmd.mask = (uint16_t)json_getInteger( mask );
+		cmd.state = (uint16_t)json_getInteger( state );
+	}
+	if ( tog && JSON_INTEGER == json_getType( tog ) ) {
+		cmd.toggle = (uint16_t)json_getInteger( tog );
+	}
+	if ((cmd.mask == 0) && (cmd.toggle == 0)){
+		LogError(("Error, no mask or toggle property found."));
+		return ;
+	}
+
+	post(&cmd);
+}
+
+/***
+ * Add a JSON string command
+ * {"mask": bits, "state": bits} and/or {"toggle": bits}
+ * Commands longer than ACT_JSON_LEN - 1 are dropped
+ * @param jsonStr
+ * @param len
+ */
+void ActuatorBankAgent::addJSON(const void  *jsonStr, size_t len){
+	//Larger message would never fit the run loop's buffer and block the rest
+	if (len > (ACT_JSON_LEN - 1)){
+		LogWarn(("JSON too long, %u bytes dropped\n", (unsigned int)len));
+		return;
+	}
+	if (xBuffer != NULL){
+		size_t res = xMessageBufferSend(
+			xBuffer,
+			jsonStr,
+			len,
+			0);
+
+		if (res != len){
+			LogError(("Failed to write"));
+		} else {
+			wake();
+		}
+	}
+}
@@ -0,0 +1,199 @@
+/*
+ * ActuatorBankAgent.h
+ *
+ * Manage a bank of output pads, such as relays and LEDs, as one agent.
+ * Channels are addressed by bitmask. All commands waiting when the agent
+ * wakes are applied as one batch with a single masked GPIO write, and
+ * the combined state is published once per batch.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _ACTUATORBANKAGENT_H_
+#define _ACTUATORBANKAGENT_H_
+
+#include "Agent.h"
+#include "SwitchObserver.h"
+#include "SwitchMgr.h"
+#include "tiny-json.h"
+
+#include "pico/stdlib.h"
+#include "queue.h"
+#include "message_buffer.h"
+#include "MQTTConfig.h"
+#include "MQTTInterface.h"
+
+//Max channels in the bank, one bit each in a command
+#ifndef ACT_BANK_MAX
+#define ACT_BANK_MAX 		16
+#endif
+
+//Switches that can toggle a channel
+#ifndef ACT_BANK_SWITCHES
+#define ACT_BANK_SWITCHES 	4
+#endif
+
+#define ACT_QUEUE_LEN 		8
+#define MQTT_TOPIC_ACT_STATE "ACT/state"
+#define ACT_BUFFER_LEN 		256
+#define ACT_JSON_LEN 		64
+#define ACT_JSON_POOL 		6
+
+class ActuatorBankAgent : public Agent, public SwitchObserver {
+public:
+	/***
+	 * Constructor
+	 * @param pads - GPIO pads of the outputs, channel 0 first
+	 * @param count - number of pads (up to ACT_BANK_MAX)
+	 * @param interface - MQTT Interface that state will be notified to
+	 */
+	ActuatorBankAgent(const uint8_t *pads, uint8_t count,
+			MQTTInterface *interface);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~ActuatorBankAgent();
+
+	/***
+	 * Attach a SPST non latched switch that toggles channels.
+	 * Presses arrive from the switch sample timer task
+	 * @param spstGP - GPIO pad of the switch
+	 * @param channels - bitmask of channels to toggle on a press
+	 * @return false if no more switches can be attached
+	 */
+	bool addSwitch(uint8_t spstGP, uint16_t channels);
+
+	/***
+	 * Set channels in mask to the matching bits of state
+	 * @param mask - channels to change
+	 * @param state - new state for those channels
+	 */
+	void set(uint16_t mask, uint16_t state);
+
+	/***
+	 * Toggle the channels in mask
+	 * @param mask - channels to toggle
+	 */
+	void toggle(uint16_t mask);
+
+	/***
+	 * Add a JSON string command
+	 * {"mask": bits, "state": bits} and/or {"toggle": bits}
+	 * Commands longer than ACT_JSON_LEN - 1 are dropped
+	 * @param jsonStr
+	 * @param len
+	 */
+	void addJSON(const void  *jsonStr, size_t len);
+
+	/***
+	 * Current state of all channels
+	 * @return bitmask
+	 */
+	uint16_t getState();
+
+	/***
+	 * Number of batches applied
+	 * @return
+	 */
+	uint32_t getBatches();
+
+	/***
+	 * Number of commands applied
+	 * @return
+	 */
+	uint32_t getCmds();
+
+	/***
+	 * Handle a short press from a switch
+	 * @param gp - GPIO number of the switch
+	 */
+	virtual void handleShortPress(uint8_t gp);
+
+	/***
+	 * Handle a long press from a switch
+	 * @param gp - GPIO number of the switch
+	 */
+	virtual void handleLongPress(uint8_t gp);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	struct ActuatorCmd {
+		uint16_t mask;
+		uint16_t state;
+		uint16_t toggle;
+	};
+
+	/***
+	 * Queue a command
+	 * @param cmd
+	 */
+	void post(const ActuatorCmd *cmd);
+
+	/***
+	 * Parse a JSON string and queue the command
+	 * @param str - JSON String
+	 */
+	void parseJSON(char *str);
+
+	/***
+	 * Write the channels to their pads and publish the state
+	 * @param state - new state of all channels
+	 */
+	void execBatch(uint16_t state);
+
+	/***
+	 * Convert a channel bitmask to a GPIO pad bitmask
+	 * @param channels
+	 * @return GPIO mask
+	 */
+	uint32_t padMask(uint16_t channels);
+
+	//Interface to publish state to MQTT
+	MQTTInterface *pInterface = NULL;
+
+	// Topic to publish on
+	char * pTopicActState = NULL;
+
+	//Output pads by channel
+	uint8_t xPads[ACT_BANK_MAX];
+	uint8_t xCount = 0;
+
+	//Bits of the channels in use
+	uint16_t xAll = 0;
+
+	//State of the channels
+	uint16_t xState = 0;
+
+	//Switches and the channels they toggle
+	SwitchMgr *pSwitchMgrs[ACT_BANK_SWITCHES];
+	uint8_t xSwitchPads[ACT_BANK_SWITCHES];
+	uint16_t xSwitchChannels[ACT_BANK_SWITCHES];
+	uint8_t xNumSwitches = 0;
+
+	//Queue of commands
+	QueueHandle_t xCmdQ = NULL;
+
+	// Message buffer handle
+	MessageBufferHandle_t xBuffer = NULL;
+
+	// Json decoding buffer
+	json_t pJsonPool[ ACT_JSON_POOL ];
+
+	uint32_t xBatches = 0;
+	uint32_t xCmds = 0;
+};
+
+#endif /* _ACTUATORBANKAGENT_H_ */
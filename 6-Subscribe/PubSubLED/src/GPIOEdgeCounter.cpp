@@ -0,0 +1,59 @@
+/*
+ * GPIOEdgeCounter.cpp
+ *
+ * Telemetry observer that counts the edges seen on GPIO pads.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "GPIOEdgeCounter.h"
+
+/***
+ * Constructor
+ */
+GPIOEdgeCounter::GPIOEdgeCounter() {
+	for (uint8_t i=0; i < NUM_GPIO; i++){
+		xCounts[i] = 0;
+	}
+}
+
+/***
+ * Destructor
+ */
+GPIOEdgeCounter::~GPIOEdgeCounter() {
+	// NOP
+}
+
+/***
+ * Start counting edges on a pad
+ * @param gpio - GPIO number
+ * @param edges - GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+ * @return false if the pad has no room for another observer
+ */
+bool GPIOEdgeCounter::watch(uint gpio, uint32_t edges){
+	return GPIOInputMgr::getMgr()->addObserver(gpio, this, edges);
+}
+
+/***
+ * Count an edge
+ * @param gpio - GPIO number
+ * @param events - Event
+ */
+void GPIOEdgeCounter::handleGPIO(uint gpio, uint32_t events){
+	if (gpio < NUM_GPIO){
+		xCounts[gpio]++;
+	}
+}
+
+/***
+ * Edges counted on a pad
+ * @param gpio - GPIO number
+ * @return
+ */
+uint32_t GPIOEdgeCounter::getCount(uint gpio){
+	if (gpio >= NUM_GPIO){
+		return 0;
+	}
+	return xCounts[gpio];
+}
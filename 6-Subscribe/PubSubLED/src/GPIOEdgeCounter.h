@@ -0,0 +1,55 @@
+/*
+ * GPIOEdgeCounter.h
+ *
+ * Telemetry observer that counts the edges seen on GPIO pads.
+ * Can share a pad with another observer, such as a SwitchMgr.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _GPIOEDGECOUNTER_H_
+#define _GPIOEDGECOUNTER_H_
+
+#include "GPIOObserver.h"
+#include "GPIOInputMgr.h"
+
+class GPIOEdgeCounter : public GPIOObserver {
+public:
+	/***
+	 * Constructor
+	 */
+	GPIOEdgeCounter();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~GPIOEdgeCounter();
+
+	/***
+	 * Start counting edges on a pad
+	 * @param gpio - GPIO number
+	 * @param edges - GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+	 * @return false if the pad has no room for another observer
+	 */
+	bool watch(uint gpio, uint32_t edges = GPIO_IRQ_EDGE_FALL);
+
+	/***
+	 * Count an edge
+	 * @param gpio - GPIO number
+	 * @param events - Event
+	 */
+	virtual void handleGPIO(uint gpio, uint32_t events);
+
+	/***
+	 * Edges counted on a pad
+	 * @param gpio - GPIO number
+	 * @return
+	 */
+	uint32_t getCount(uint gpio);
+
+private:
+	uint32_t xCounts[NUM_GPIO];
+};
+
+#endif /* _GPIOEDGECOUNTER_H_ */
@@ -19,7 +19,8 @@ GPIOInputMgr *GPIOInputMgr::pSelf = NULL;
  */
 GPIOInputMgr::GPIOInputMgr() {
 	for (uint8_t i=0; i < NUM_GPIO; i++){
-		pObservers[i] = NULL;
+		xNumObservers[i] = 0;
+		xPadEdges[i] = 0;
 	}
 	GPIOInputMgr::pSelf = this;
 }
@@ -28,27 +29,71 @@ GPIOInputMgr::GPIOInputMgr() {
  * Destructor
  */
 GPIOInputMgr::~GPIOInputMgr() {
-	//NOP
+	stop();
 }
 
 /***
- * Only one observer per GPIO Pad
+ * Add an observer for edges on a GPIO Pad. Up to GPIO_PAD_OBSERVERS
+ * can share a pad, adding one again updates its edges.
+ * Starts the dispatcher task on first use
  * @param gpio - number of the GPIO Pad
  * @param obs - Observer object
+ * @param edges - GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+ * @return false if the pad already has GPIO_PAD_OBSERVERS
  */
-void GPIOInputMgr::addObserver(uint gpio, GPIOObserver *obs){
-	//Initialise the GPIO pin
-	gpio_init(gpio);
-	gpio_set_dir(gpio, GPIO_IN);
-
-	//Setup Interrupt
-	gpio_set_irq_enabled_with_callback(gpio,
-		GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
-		true,
-		GPIOInputMgr::gpioCallback
-	);
-
-	pObservers[gpio] = obs;
+bool GPIOInputMgr::addObserver(uint gpio, GPIOObserver *obs, uint32_t edges){
+	if (gpio >= NUM_GPIO){
+		return false;
+	}
+
+	if (xHandle == NULL){
+		start("GPIOInput", GPIO_DISPATCH_PRIORITY);
+	}
+
+	//Update the edges of an existing observer, else add it
+	uint8_t count = xNumObservers[gpio];
+	uint8_t i;
+	for (i=0; i < count; i++){
+		if (xObservers[gpio][i].obs == obs){
+			xObservers[gpio][i].edges = edges;
+			break;
+		}
+	}
+	if (i == count){
+		if (count >= GPIO_PAD_OBSERVERS){
+			printf("GPIO %d already has %d observers\n", gpio, count);
+			return false;
+		}
+		xObservers[gpio][count].obs = obs;
+		xObservers[gpio][count].edges = edges;
+
+		//Entry must be complete before the dispatcher can see it
+		__compiler_memory_barrier();
+		xNumObservers[gpio] = count + 1;
+	}
+
+	uint8_t padEdges = 0;
+	for (i=0; i < xNumObservers[gpio]; i++){
+		padEdges |= xObservers[gpio][i].edges;
+	}
+
+	//Only initialise the pin for the first observer, so any pull set
+	//up by an earlier observer is kept
+	if (xPadEdges[gpio] == 0){
+		gpio_init(gpio);
+		gpio_set_dir(gpio, GPIO_IN);
+		gpio_set_irq_enabled_with_callback(gpio,
+			padEdges,
+			true,
+			GPIOInputMgr::gpioCallback
+		);
+	} else {
+		gpio_set_irq_enabled(gpio, xPadEdges[gpio] & ~padEdges, false);
+		gpio_set_irq_enabled(gpio, padEdges, true);
+	}
+	xPadEdges[gpio] = padEdges;
+
+	return true;
 }
 
 /***
@@ -63,14 +108,103 @@ void GPIOInputMgr::gpioCallback (uint gpio, uint32_t events){
 }
 
 /***
- * Handle a GPIO event by passing call to the correct object
+ * Record a GPIO event in the ring and wake the dispatcher
  * @param gpio = GPIO Pad number
  * @param events - mask of the events
  */
 void GPIOInputMgr::handleGPIO(uint gpio, uint32_t events){
-	if (pObservers[gpio] != NULL){
-		pObservers[gpio]->handleGPIO(gpio, events);
+	uint32_t head = xHead;
+	if ((head - xTail) >= GPIO_EVENT_RING){
+		xOverflows++;
+		return;
+	}
+
+	GPIOEvent *ev = &xRing[head & (GPIO_EVENT_RING - 1)];
+	ev->us = time_us_32();
+	ev->gpio = gpio;
+	ev->events = events;
+
+	//Entry must be complete before the dispatcher can see it
+	__compiler_memory_barrier();
+	xHead = head + 1;
+
+	wakeFromISR();
+}
+
+/***
+ * Dispatcher run loop, passes events from the ring to the observers
+ */
+void GPIOInputMgr::run(){
+	while (true) { // Loop forever
+		while (xTail != xHead){
+			GPIOEvent ev = xRing[xTail & (GPIO_EVENT_RING - 1)];
+			__compiler_memory_barrier();
+			xTail = xTail + 1;
+
+			uint32_t latency = time_us_32() - ev.us;
+			if (latency > xMaxLatency){
+				xMaxLatency = latency;
+			}
+			xTotalLatency += latency;
+			xDispatched++;
+
+			//Only observers interested in the edges that fired
+			GPIOObserverEntry *obs = xObservers[ev.gpio];
+			uint8_t count = xNumObservers[ev.gpio];
+			for (uint8_t i=0; i < count; i++){
+				uint32_t events = ev.events & obs[i].edges;
+				if (events != 0){
+					obs[i].obs->handleGPIOEvent(ev.gpio, events, ev.us);
+				}
+			}
+		}
+
+		//Sleep until the interrupt records more events
+		waitForWork();
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE GPIOInputMgr::getMaxStackSize(){
+	return GPIO_DISPATCH_STACK;
+}
+
+/***
+ * Number of events dispatched to observers
+ * @return
+ */
+uint32_t GPIOInputMgr::getDispatched(){
+	return xDispatched;
+}
+
+/***
+ * Number of events lost as the ring was full
+ * @return
+ */
+uint32_t GPIOInputMgr::getOverflows(){
+	return xOverflows;
+}
+
+/***
+ * Worst time from interrupt to observer being called
+ * @return micro seconds
+ */
+uint32_t GPIOInputMgr::getMaxLatencyUs(){
+	return xMaxLatency;
+}
+
+/***
+ * Mean time from interrupt to observer being called
+ * @return micro seconds
+ */
+uint32_t GPIOInputMgr::getAvgLatencyUs(){
+	if (xDispatched == 0){
+		return 0;
 	}
+	return (uint32_t)(xTotalLatency / xDispatched);
 }
 
 /***
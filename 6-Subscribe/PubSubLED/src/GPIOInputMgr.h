@@ -4,6 +4,10 @@
  * Manage all GPIOInputs through a single class object to get around the single
  * callback function per core issue
  *
+ * The interrupt only records the pad, edges and a microsecond timestamp in a
+ * ring and wakes the dispatcher task. Observers are then called from that
+ * task, not from interrupt context.
+ *
  *  Created on: 6 Jul 2022
  *      Author: jondurrant
  */
@@ -12,10 +16,31 @@
 #define PIR_PIRTIMER_SRC_GPIOMGR_H_
 
 #include "GPIOObserver.h"
+#include "Agent.h"
 
 #define NUM_GPIO 29
 
-class GPIOInputMgr {
+//Observers that can share one GPIO pad
+#ifndef GPIO_PAD_OBSERVERS
+#define GPIO_PAD_OBSERVERS 		4
+#endif
+
+#define GPIO_EDGES_BOTH 		(GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL)
+
+//Events held between interrupt and dispatch, must be a power of 2
+#ifndef GPIO_EVENT_RING
+#define GPIO_EVENT_RING 		32
+#endif
+
+#ifndef GPIO_DISPATCH_PRIORITY
+#define GPIO_DISPATCH_PRIORITY 	(configMAX_PRIORITIES - 1)
+#endif
+
+#ifndef GPIO_DISPATCH_STACK
+#define GPIO_DISPATCH_STACK 	300
+#endif
+
+class GPIOInputMgr : public Agent {
 public:
 	/***
 	 * Constructor
@@ -28,11 +53,16 @@ public:
 	virtual ~GPIOInputMgr();
 
 	/***
-	 * Only one observer per GPIO Pad
+	 * Add an observer for edges on a GPIO Pad. Up to GPIO_PAD_OBSERVERS
+	 * can share a pad, adding one again updates its edges.
+	 * Starts the dispatcher task on first use
 	 * @param gpio - number of the GPIO Pad
 	 * @param obs - Observer object
+	 * @param edges - GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+	 * @return false if the pad already has GPIO_PAD_OBSERVERS
 	 */
-	void addObserver(uint gpio, GPIOObserver *obs);
+	bool addObserver(uint gpio, GPIOObserver *obs,
+			uint32_t edges = GPIO_EDGES_BOTH);
 
 	/***
 	 * Get the GPIOInputMgr object
@@ -41,9 +71,60 @@ public:
 	 */
 	static GPIOInputMgr *getMgr ();
 
+	/***
+	 * Number of events dispatched to observers
+	 * @return
+	 */
+	uint32_t getDispatched();
+
+	/***
+	 * Number of events lost as the ring was full
+	 * @return
+	 */
+	uint32_t getOverflows();
+
+	/***
+	 * Worst time from interrupt to observer being called
+	 * @return micro seconds
+	 */
+	uint32_t getMaxLatencyUs();
+
+	/***
+	 * Mean time from interrupt to observer being called
+	 * @return micro seconds
+	 */
+	uint32_t getAvgLatencyUs();
+
+protected:
+	/***
+	 * Dispatcher run loop, passes events from the ring to the observers
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
 private:
-	// The list of observers, one per GPIO pad
-	GPIOObserver *pObservers[NUM_GPIO];
+	struct GPIOEvent {
+		uint32_t us;
+		uint8_t gpio;
+		uint8_t events;
+	};
+
+	struct GPIOObserverEntry {
+		GPIOObserver *obs;
+		uint8_t edges;
+	};
+
+	// The observers of each GPIO pad and the edges they want
+	GPIOObserverEntry xObservers[NUM_GPIO][GPIO_PAD_OBSERVERS];
+	uint8_t xNumObservers[NUM_GPIO];
+
+	// Edges enabled on each pad, the union of its observers' edges
+	uint8_t xPadEdges[NUM_GPIO];
 
 	//Used for call back functions to find the object
 	static GPIOInputMgr * pSelf;
@@ -56,14 +137,21 @@ private:
 	static void gpioCallback (uint gpio, uint32_t events);
 
 	/***
-	 * Handle a GPIO event by passing call to the correct object
+	 * Record a GPIO event in the ring and wake the dispatcher
 	 * @param gpio = GPIO Pad number
 	 * @param events - mask of the events
 	 */
 	void handleGPIO(uint gpio, uint32_t events);
 
+	//Ring written only by the interrupt and read only by the dispatcher
+	GPIOEvent xRing[GPIO_EVENT_RING];
+	volatile uint32_t xHead = 0;
+	volatile uint32_t xTail = 0;
 
-
+	volatile uint32_t xOverflows = 0;
+	uint32_t xDispatched = 0;
+	uint32_t xMaxLatency = 0;
+	uint64_t xTotalLatency = 0;
 };
 
 #endif /* PIR_PIRTIMER_SRC_GPIOMGR_H_ */
@@ -16,3 +16,14 @@ GPIOObserver::~GPIOObserver() {
 	// TODO Auto-generated destructor stub
 }
 
+/***
+ * handle GPIO event passed on by GPIOInputMgr dispatcher task.
+ * Default passes through to handleGPIO
+ * @param gpio - GPIO number
+ * @param events - Event
+ * @param us - time of the interrupt in micro seconds
+ */
+void GPIOObserver::handleGPIOEvent(uint gpio, uint32_t events, uint32_t us){
+	handleGPIO(gpio, events);
+}
+
@@ -27,6 +27,15 @@ public:
 	 */
 	virtual void handleGPIO(uint gpio, uint32_t events)=0;
 
+	/***
+	 * handle GPIO event passed on by GPIOInputMgr dispatcher task.
+	 * Default passes through to handleGPIO
+	 * @param gpio - GPIO number
+	 * @param events - Event
+	 * @param us - time of the interrupt in micro seconds
+	 */
+	virtual void handleGPIOEvent(uint gpio, uint32_t events, uint32_t us);
+
 };
 
 #endif /* PIR_PIRTIMER_SRC_GPIOOBSERVER_H_ */
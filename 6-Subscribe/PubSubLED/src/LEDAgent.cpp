@@ -84,7 +84,7 @@ LEDAgent::~LEDAgent() {
  * @param gp - GPIO number of the switch
  */
 void LEDAgent::handleShortPress(uint8_t gp){
-	intToggle();
+	toggle();
 }
 
 /***
@@ -92,7 +92,7 @@ void LEDAgent::handleShortPress(uint8_t gp){
  * @param gp - GPIO number of the switch
  */
 void LEDAgent::handleLongPress(uint8_t gp){
-	intToggle();
+	toggle();
 }
 
 
@@ -110,6 +110,8 @@ void LEDAgent::setOn(bool on){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		posted();
 	}
 }
 
@@ -122,28 +124,17 @@ void LEDAgent::toggle(){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		posted();
 	}
 }
 
-/***
- * Toggle LED state from within an intrupt
- */
-void LEDAgent::intToggle(){
-	LEDAction action = LEDToggle;
-	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
-	if (res != pdTRUE){
-		LogWarn(("Queue is full\n"));
-	}
-}
-
-
 /***
   * Main Run Task for agent
   */
 void LEDAgent::run(){
-	BaseType_t res;
 	LEDAction action = LEDOff;
-	char jsonStr[LED_JSON_LEN];
+	char jsonStr[LED_JSON_LEN + 1];
 	size_t readLen;
 
 	if (xCmdQ == NULL){
@@ -151,19 +142,16 @@ void LEDAgent::run(){
 	}
 
 	while (true) { // Loop forever
-		readLen = xMessageBufferReceive(
-						 xBuffer,
-				         jsonStr,
-						 LED_JSON_LEN,
-						 0
-				    );
-		if (readLen > 0){
+		//Commands queued after this are timed on the next pass
+		uint32_t postUs = xPostUs;
+		xPostUs = 0;
+
+		while ((readLen = xMessageBufferReceive(xBuffer, jsonStr, LED_JSON_LEN, 0)) > 0){
 			jsonStr[readLen] = 0;
 	        parseJSON(jsonStr);
 		}
 
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
+		while (xQueueReceive(xCmdQ, (void *)&action, 0) == pdTRUE){
 			switch(action){
 				case LEDOff:{
 					execLed(false);
@@ -178,8 +166,24 @@ void LEDAgent::run(){
 					break;
 				}
 			}
-			taskYIELD();
 		}
+
+		//Time from first queued command to it being applied
+		if (postUs != 0){
+			uint32_t latency = time_us_32() - postUs;
+			if (latency > xMaxLatency){
+				xMaxLatency = latency;
+			}
+			xTotalLatency += latency;
+			xApplied++;
+		}
+
+#if LED_AGENT_POLL
+		taskYIELD();
+#else
+		//Sleep until more work is queued
+		waitForWork();
+#endif
 	}
 }
 
@@ -246,6 +250,11 @@ void LEDAgent::parseJSON(char *str){
  * @param jsonStr
  */
 void LEDAgent::addJSON(const void  *jsonStr, size_t len){
+	//Larger message would never fit the run loop's buffer and block the rest
+	if (len > LED_JSON_LEN){
+		LogWarn(("JSON too long, %u bytes dropped\n", (unsigned int)len));
+		return;
+	}
 	if (xBuffer != NULL){
 		size_t res = xMessageBufferSend(
 			xBuffer,
@@ -255,6 +264,39 @@ void LEDAgent::addJSON(const void  *jsonStr, size_t len){
 
 		if (res != len){
 			LogError(("Failed to write"));
+		} else {
+			posted();
 		}
 	}
 }
+
+
+/***
+ * Note that work has been queued and wake the agent
+ */
+void LEDAgent::posted(){
+	//JSON commands requeue from the agent itself, so are already timed
+	if ((xPostUs == 0) && (xTaskGetCurrentTaskHandle() != xHandle)){
+		xPostUs = time_us_32();
+	}
+	wake();
+}
+
+/***
+ * Worst time from a command being queued to the agent applying it
+ * @return micro seconds
+ */
+uint32_t LEDAgent::getMaxLatencyUs(){
+	return xMaxLatency;
+}
+
+/***
+ * Mean time from a command being queued to the agent applying it
+ * @return micro seconds
+ */
+uint32_t LEDAgent::getAvgLatencyUs(){
+	if (xApplied == 0){
+		return 0;
+	}
+	return (uint32_t)(xTotalLatency / xApplied);
+}
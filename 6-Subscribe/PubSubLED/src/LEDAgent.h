@@ -25,9 +25,17 @@
 #define LED_QUEUE_LEN 	5
 #define MQTT_TOPIC_LED_STATE "LED/state"
 #define LED_BUFFER_LEN 	256
-#define LED_JSON_LEN 	20
+//Longest JSON command accepted by addJSON
+#ifndef LED_JSON_LEN
+#define LED_JSON_LEN 	64
+#endif
 #define LED_JSON_POOL 	5
 
+//Set to 1 to poll for work rather than block, to compare idle CPU and latency
+#ifndef LED_AGENT_POLL
+#define LED_AGENT_POLL 	0
+#endif
+
 
 class LEDAgent : public Agent, public SwitchObserver {
 public:
@@ -74,6 +82,18 @@ public:
 	 */
 	virtual void handleLongPress(uint8_t gp);
 
+	/***
+	 * Worst time from a command being queued to the agent applying it
+	 * @return micro seconds
+	 */
+	uint32_t getMaxLatencyUs();
+
+	/***
+	 * Mean time from a command being queued to the agent applying it
+	 * @return micro seconds
+	 */
+	uint32_t getAvgLatencyUs();
+
 protected:
 	/***
 	 * Task main run loop
@@ -87,17 +107,17 @@ protected:
 	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
 
 private:
-	/***
-	 * Toggle LED state from within an intrupt
-	 */
-	void intToggle();
-
 	/***
 	 * Execute the state on the LED and notify MQTT interface
 	 * @param state
 	 */
 	void execLed(bool state);
 
+	/***
+	 * Note that work has been queued and wake the agent
+	 */
+	void posted();
+
 	/***
 	 * Parse a JSON string and add request to queue
 	 * @param str - JSON Strging
@@ -130,6 +150,12 @@ private:
 	// Json decoding buffer
 	json_t pJsonPool[ LED_JSON_POOL ];
 
+	//Time the oldest unapplied command was queued, 0 if none
+	volatile uint32_t xPostUs = 0;
+	uint32_t xMaxLatency = 0;
+	uint64_t xTotalLatency = 0;
+	uint32_t xApplied = 0;
+
 };
 
 
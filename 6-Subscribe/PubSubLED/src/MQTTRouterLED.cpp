@@ -11,8 +11,9 @@
 #define LED_TOPIC  "LED"
 #define PAYLOAD_ON "on"
 
-MQTTRouterLED::MQTTRouterLED(LEDAgent *agent) {
+MQTTRouterLED::MQTTRouterLED(LEDAgent *agent, ActuatorBankAgent *bank) {
 	pAgent = agent;
+	pBank = bank;
 }
 
 MQTTRouterLED::~MQTTRouterLED() {
@@ -41,6 +42,24 @@ void MQTTRouterLED::subscribe(MQTTInterface *interface){
 	if (pLedTopic != NULL){
 		interface->subToTopic(pLedTopic, 1);
 	}
+
+	if (pBank == NULL){
+		return;
+	}
+	if (pActTopic == NULL){
+		const char *id = interface->getId();
+		pActTopic = (char *)pvPortMalloc(
+			MQTTTopicHelper::lenThingTopic(id, MQTT_ACT_REQ_TOPIC)
+			);
+		if (pActTopic != NULL){
+			MQTTTopicHelper::genThingTopic(pActTopic, id, MQTT_ACT_REQ_TOPIC);
+		} else {
+			LogError( ("Unable to allocate topic") );
+		}
+	}
+	if (pActTopic != NULL){
+		interface->subToTopic(pActTopic, 1);
+	}
 }
 
 /***
@@ -57,6 +76,14 @@ void MQTTRouterLED::route(const char *topic,
 		size_t payloadLen,
 		MQTTInterface *interface){
 
+	if ((pBank != NULL) && (pActTopic != NULL)){
+		if ((strlen(pActTopic) == topicLen) &&
+				(strncmp(pActTopic, topic, topicLen) == 0)){
+			pBank->addJSON(payload, payloadLen);
+			return;
+		}
+	}
+
 	if (pAgent != NULL){
 		pAgent->addJSON(payload, payloadLen);
 	}
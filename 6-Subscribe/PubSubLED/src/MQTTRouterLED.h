@@ -13,15 +13,19 @@
 
 #include "tiny-json.h"
 #include "LEDAgent.h"
+#include "ActuatorBankAgent.h"
 
 #define MQTT_LED_REQ_TOPIC 	"LED/req"
+#define MQTT_ACT_REQ_TOPIC 	"ACT/req"
 
 class MQTTRouterLED : public MQTTRouter{
 public:
 	/***
 	 * Constructor
+	 * @param agent - LED agent for LED requests
+	 * @param bank - optional actuator bank for ACT requests
 	 */
-	MQTTRouterLED(LEDAgent *agent);
+	MQTTRouterLED(LEDAgent *agent, ActuatorBankAgent *bank = NULL);
 	virtual ~MQTTRouterLED();
 
 	/***
@@ -46,6 +50,8 @@ public:
 private:
 	LEDAgent *pAgent = NULL;
 	char *pLedTopic = NULL;
+	ActuatorBankAgent *pBank = NULL;
+	char *pActTopic = NULL;
 
 };
 
@@ -9,9 +9,17 @@
 #include "pico/stdlib.h"
 #include <stdlib.h>
 #include "hardware/gpio.h"
-#include "pico/time.h"
 #include <stdio.h>
-#include "GPIOInputMgr.h"
+#include "task.h"
+
+//Times in samples
+#define SAMPLES(ms)		((ms) / SWITCH_SAMPLE_MS)
+#define DEBOUNCE_MASK 	((uint8_t)((1 << SWITCH_DEBOUNCE) - 1))
+
+SwitchMgr *SwitchMgr::pSwitches[SWITCH_MAX];
+uint8_t SwitchMgr::xNumSwitches = 0;
+TimerHandle_t SwitchMgr::xTimer = NULL;
+StaticTimer_t SwitchMgr::xTimerBuf;
 
 
 /***
@@ -23,12 +31,45 @@ SwitchMgr::SwitchMgr(uint8_t gp) {
 	xGP = gp;
 
 	//Setup GPIO
-	GPIOInputMgr::getMgr()->addObserver(xGP, this);
+	gpio_init(xGP);
+	gpio_set_dir(xGP, GPIO_IN);
 	gpio_pull_up (xGP);
+
+	//Join the switches sampled by the shared timer
+	taskENTER_CRITICAL();
+	if (xNumSwitches < SWITCH_MAX){
+		pSwitches[xNumSwitches] = this;
+		xNumSwitches++;
+	} else {
+		printf("Too many switches, %d not sampled\n", xGP);
+	}
+	taskEXIT_CRITICAL();
+
+	if (xTimer == NULL){
+		xTimer = xTimerCreateStatic("Switch",
+				pdMS_TO_TICKS(SWITCH_SAMPLE_MS),
+				pdTRUE,
+				NULL,
+				SwitchMgr::sampleAll,
+				&xTimerBuf);
+		if (xTimer == NULL){
+			printf("Unable to create switch timer\n");
+		} else {
+			xTimerStart(xTimer, 0);
+		}
+	}
 }
 
 SwitchMgr::~SwitchMgr() {
-	// NOP
+	taskENTER_CRITICAL();
+	for (uint8_t i=0; i < xNumSwitches; i++){
+		if (pSwitches[i] == this){
+			xNumSwitches--;
+			pSwitches[i] = pSwitches[xNumSwitches];
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
 }
 
 /***
@@ -40,55 +81,108 @@ void SwitchMgr::setObserver(SwitchObserver * obs){
 }
 
 /***
- * Handle a short press event by notifying the observer
+ * Number of raw changes rejected as bounce
+ * @return
  */
-void SwitchMgr::handleShortPress(){
-	if (pObs != NULL){
-		pObs->handleShortPress(xGP);
-	}
+uint32_t SwitchMgr::getBounces(){
+	return xBounces;
 }
 
 /***
- * Handle a long press event by notifying the observer
+ * Sample timer callback, samples every switch
+ * @param timer
  */
-void SwitchMgr::handleLongPress(){
-	if (pObs != NULL){
-		pObs->handleLongPress(xGP);
+void SwitchMgr::sampleAll(TimerHandle_t timer){
+	for (uint8_t i=0; i < xNumSwitches; i++){
+		SwitchMgr *sw = pSwitches[i];
+		//Pulled up so pressed reads low
+		sw->sample(!gpio_get(sw->xGP));
 	}
 }
 
-
 /***
- * handle GPIO push switch events
- * @param gpio - GPIO number
- * @param events - Event
+ * Take one sample of the switch and step the debounce state machine
+ * @param pressed - true if the pad reads as pressed
  */
-void SwitchMgr::handleGPIO(uint gpio, uint32_t events){
-	//Check callback is for the right GPIO Pin
-	if (gpio == xGP){
+void SwitchMgr::sample(bool pressed){
+	xHistory = (xHistory << 1) | (pressed ? 1 : 0);
+
+	//Only change once the last SWITCH_DEBOUNCE samples agree
+	uint8_t recent = xHistory & DEBOUNCE_MASK;
+	if (recent == DEBOUNCE_MASK){
+		xPressed = true;
+	} else if (recent == 0){
+		xPressed = false;
+	} else if ((pressed == xPressed) && (((xHistory ^ (xHistory >> 1)) & 1) != 0)){
+		//Fell back before the change settled
+		xBounces++;
+	}
 
-		//If Falling Edge then collect time
-		if ((events & GPIO_IRQ_EDGE_FALL) > 0){
-			xFallingTime = to_ms_since_boot (get_absolute_time ());
-		}
+	if (xSamples < UINT16_MAX){
+		xSamples++;
+	}
 
-		//If Rising Edge
-		if ((events & GPIO_IRQ_EDGE_RISE) > 0){
-			uint32_t stableTime = to_ms_since_boot (get_absolute_time ()) - xFallingTime;
-			xFallingTime = 0;
+	switch(xState){
+	case SwitchIdle:
+		if (xPressed){
+			xState = SwitchDown;
+			xSamples = 0;
+		}
+		break;
+
+	case SwitchDown:
+		if (!xPressed){
+			if (xSamples < SAMPLES(LONG_PRESS_TIME)){
+				//Wait to see if this is the first of a double click
+				xState = SwitchUp;
+				xSamples = 0;
+			} else {
+				xState = SwitchIdle;
+				if (pObs != NULL){
+					pObs->handleLongPress(xGP);
+				}
+			}
+		} else if (xSamples >= SAMPLES(HOLD_TIME)){
+			xState = SwitchHeld;
+			xSamples = 0;
+			xRepeats = 0;
+			if (pObs != NULL){
+				pObs->handleHoldStart(xGP);
+			}
+		}
+		break;
+
+	case SwitchHeld:
+		if (!xPressed){
+			xState = SwitchIdle;
+		} else if (xSamples >= SAMPLES(HOLD_REPEAT_TIME)){
+			xSamples = 0;
+			xRepeats++;
+			if (pObs != NULL){
+				pObs->handleHoldRepeat(xGP, xRepeats);
+			}
+		}
+		break;
 
-			//If valid length then handle press
-			if ( (stableTime > SHORT_PRESS_TIME) &&
-				 (stableTime < LONG_PRESS_TIME)){
-				handleShortPress();
+	case SwitchUp:
+		if (xPressed){
+			xState = SwitchDown2;
+			if (pObs != NULL){
+				pObs->handleDoubleClick(xGP);
 			}
-			if ( (stableTime >= LONG_PRESS_TIME) &&
-					 (stableTime < MAX_PRESS_TIME)){
-				handleLongPress();
+		} else if (xSamples >= SAMPLES(DOUBLE_CLICK_TIME)){
+			xState = SwitchIdle;
+			if (pObs != NULL){
+				pObs->handleShortPress(xGP);
 			}
+		}
+		break;
 
+	case SwitchDown2:
+		//Second press of a double click, wait for release
+		if (!xPressed){
+			xState = SwitchIdle;
 		}
+		break;
 	}
-
-
 }
@@ -6,23 +6,52 @@
  *
  *      Manage a SPST switch on a specific GPIO pin.
  *      Notify observers of press of the switch
- *      Manage through Interrupt strategy
+ *      All switches are sampled from one shared FreeRTOS timer and
+ *      debounced, so bounce and interrupt storms are ignored. Events:
+ *      click, double click, long press, hold start and hold repeat
  */
 
 #ifndef SRC_SWITCHMGR_H_
 #define SRC_SWITCHMGR_H_
 
 #include "SwitchObserver.h"
-#include "GPIOObserver.h"
+#include "FreeRTOS.h"
+#include "timers.h"
 
-//Time switch must be stable as low to consider being a short press
-#define SHORT_PRESS_TIME 5 //ms
-#define LONG_PRESS_TIME 200 //ms
-#define MAX_PRESS_TIME  2000 //ms
+//Period that all switches are sampled at
+#ifndef SWITCH_SAMPLE_MS
+#define SWITCH_SAMPLE_MS 	5 //ms
+#endif
 
+//Samples that must agree before the switch is considered changed, max 8
+#ifndef SWITCH_DEBOUNCE
+#define SWITCH_DEBOUNCE 	4
+#endif
 
+//Press shorter than this is a click, longer is a long press
+#define LONG_PRESS_TIME 	200 //ms
 
-class SwitchMgr : public GPIOObserver{
+//Max gap between release and second press for a double click
+#ifndef DOUBLE_CLICK_TIME
+#define DOUBLE_CLICK_TIME 	250 //ms
+#endif
+
+//Press longer than this starts a hold, which then repeats
+#ifndef HOLD_TIME
+#define HOLD_TIME 			1000 //ms
+#endif
+
+#ifndef HOLD_REPEAT_TIME
+#define HOLD_REPEAT_TIME 	200 //ms
+#endif
+
+//Max switches sharing the sample timer
+#ifndef SWITCH_MAX
+#define SWITCH_MAX 			8
+#endif
+
+
+class SwitchMgr {
 public:
 	/***
 	 * Constructor
@@ -42,33 +71,51 @@ public:
 	void setObserver(SwitchObserver * obs);
 
 	/***
-	 * handle GPIO push switch events
-	 * @param gpio - GPIO number
-	 * @param events - Event
+	 * Take one sample of the switch and step the debounce state machine
+	 * @param pressed - true if the pad reads as pressed
 	 */
-	void handleGPIO(uint gpio, uint32_t events);
-private:
+	void sample(bool pressed);
 
 	/***
-	 * Handle a short press
+	 * Number of raw changes rejected as bounce
+	 * @return
 	 */
-	void handleShortPress();
+	uint32_t getBounces();
+
+private:
+	enum SwitchState {SwitchIdle, SwitchDown, SwitchHeld, SwitchUp, SwitchDown2};
 
 	/***
-	 * Handle a long press
+	 * Sample timer callback, samples every switch
+	 * @param timer
 	 */
-	void handleLongPress();
-
+	static void sampleAll(TimerHandle_t timer);
 
 	//GPIO number for the switch
 	uint8_t xGP = 0;
 
-	//Time falling edge was detected
-	uint32_t xFallingTime;
-
 	//Observer
 	SwitchObserver *pObs = NULL;
 
+	//Recent raw samples, newest in bit 0
+	uint8_t xHistory = 0;
+
+	//Debounced state
+	bool xPressed = false;
+
+	SwitchState xState = SwitchIdle;
+
+	//Samples since the state began or last hold repeat
+	uint16_t xSamples = 0;
+
+	uint16_t xRepeats = 0;
+	uint32_t xBounces = 0;
+
+	//Switches sharing the sample timer
+	static SwitchMgr *pSwitches[SWITCH_MAX];
+	static uint8_t xNumSwitches;
+	static TimerHandle_t xTimer;
+	static StaticTimer_t xTimerBuf;
 };
 
 #endif /* SRC_SWITCHMGR_H_ */
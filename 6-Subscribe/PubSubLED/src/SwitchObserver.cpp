@@ -39,3 +39,28 @@ void SwitchObserver::handleShortPress(uint8_t gp){
 void SwitchObserver::handleLongPress(uint8_t gp){
 	printf("Long Press on %d\n", gp);
 }
+
+/***
+ * Handle double click from switch
+ * @param gp - GPIO number of the switch
+ */
+void SwitchObserver::handleDoubleClick(uint8_t gp){
+	printf("Double Click on %d\n", gp);
+}
+
+/***
+ * Handle switch being held down past the hold time
+ * @param gp - GPIO number of the switch
+ */
+void SwitchObserver::handleHoldStart(uint8_t gp){
+	printf("Hold Start on %d\n", gp);
+}
+
+/***
+ * Handle repeat while the switch remains held
+ * @param gp - GPIO number of the switch
+ * @param count - number of repeats so far in this hold
+ */
+void SwitchObserver::handleHoldRepeat(uint8_t gp, uint16_t count){
+	//NOP
+}
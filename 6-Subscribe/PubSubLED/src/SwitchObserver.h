@@ -34,10 +34,29 @@ public:
 	virtual void handleShortPress(uint8_t gp);
 
 	/***
-	 * Handle a short press from the switch
+	 * Handle a long press from the switch
 	 * @param gp - GPIO number of the switch
 	 */
 	virtual void handleLongPress(uint8_t gp);
+
+	/***
+	 * Handle a double click from the switch
+	 * @param gp - GPIO number of the switch
+	 */
+	virtual void handleDoubleClick(uint8_t gp);
+
+	/***
+	 * Handle the switch being held down past the hold time
+	 * @param gp - GPIO number of the switch
+	 */
+	virtual void handleHoldStart(uint8_t gp);
+
+	/***
+	 * Handle repeat while the switch remains held
+	 * @param gp - GPIO number of the switch
+	 * @param count - number of repeats so far in this hold
+	 */
+	virtual void handleHoldRepeat(uint8_t gp, uint16_t count);
 };
 
 #endif /* SRC_SWITCHOBSERVER_H_ */
@@ -23,6 +23,9 @@
 #include "MQTTAgent.h"
 #include "MQTTAgentObserver.h"
 #include "LEDAgent.h"
+#include "ActuatorBankAgent.h"
+#include "GPIOInputMgr.h"
+#include "GPIOEdgeCounter.h"
 #include "MQTTRouterLED.h"
 
 
@@ -53,6 +56,10 @@
 #define LED_PAD  	    0
 #define SWITCH_PAD	 	1
 
+// Actuator bank pads, channel 0 first, and switch toggling channel 0
+#define ACT_PADS		{2, 3, 4, 5, 6, 7, 8, 9}
+#define ACT_SWITCH_PAD	10
+
 
 #define TASK_PRIORITY			( tskIDLE_PRIORITY + 1UL )
 
@@ -168,9 +175,21 @@ void main_task(void *params){
 	LEDAgent ledAgent(LED_PAD, SWITCH_PAD, &mqttAgent);
 	ledAgent.start("LEDAgent", TASK_PRIORITY);
 
-	MQTTRouterLED router(&ledAgent);
+	//Count raw falling edges of the LED switch, bounces included. SwitchMgr
+	//samples the pad from its timer so this is the pad's only observer
+	GPIOEdgeCounter pressCounter;
+	pressCounter.watch(SWITCH_PAD, GPIO_IRQ_EDGE_FALL);
+
+	static const uint8_t actPads[] = ACT_PADS;
+	ActuatorBankAgent actBank(actPads, sizeof(actPads), &mqttAgent);
+	actBank.addSwitch(ACT_SWITCH_PAD, 0x0001);
+	actBank.start("ActBank", TASK_PRIORITY);
+
+	MQTTRouterLED router(&ledAgent, &actBank);
 	mqttAgent.setRouter(&router);
 
+	uint32_t idleUs = ulTaskGetIdleRunTimeCounter();
+	uint32_t periodUs = time_us_32();
 
     while(true) {
 
@@ -178,6 +197,25 @@ void main_task(void *params){
 
         vTaskDelay(3000);
 
+        GPIOInputMgr *gpioMgr = GPIOInputMgr::getMgr();
+        printf("GPIO events %lu, lost %lu, latency avg %lu us, max %lu us\n",
+        		(unsigned long)gpioMgr->getDispatched(),
+        		(unsigned long)gpioMgr->getOverflows(),
+        		(unsigned long)gpioMgr->getAvgLatencyUs(),
+        		(unsigned long)gpioMgr->getMaxLatencyUs());
+        printf("Switch falling edges %lu\n",
+        		(unsigned long)pressCounter.getCount(SWITCH_PAD));
+
+        //Build with LED_AGENT_POLL=1 for the polling figures to compare
+        uint32_t idleNow = ulTaskGetIdleRunTimeCounter();
+        uint32_t periodNow = time_us_32();
+        printf("Idle %lu%%, LED apply latency avg %lu us, max %lu us\n",
+        		(unsigned long)((uint64_t)(idleNow - idleUs) * 100 / (periodNow - periodUs)),
+        		(unsigned long)ledAgent.getAvgLatencyUs(),
+        		(unsigned long)ledAgent.getMaxLatencyUs());
+        idleUs = idleNow;
+        periodUs = periodNow;
+
         if (!WifiHelper::isJoined()){
         	printf("AP Link is down\n");
 
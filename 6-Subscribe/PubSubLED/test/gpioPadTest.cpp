@@ -0,0 +1,87 @@
+/*
+ * gpioPadTest.cpp
+ *
+ * Host test of GPIOInputMgr with two observers on one pad, each wanting
+ * different edges. Interrupts are raised through the stand in SDK and
+ * the dispatcher run until it waits, then the edges each observer saw
+ * are checked.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "GPIOInputMgr.h"
+#include "GPIOEdgeCounter.h"
+#include "hostStubs.h"
+#include <stdio.h>
+
+#define TEST_PAD 	15
+
+class EdgeRecorder : public GPIOObserver {
+public:
+	virtual void handleGPIO(uint gpio, uint32_t events){
+		if ((events & GPIO_IRQ_EDGE_RISE) != 0){
+			xRises++;
+		}
+		if ((events & GPIO_IRQ_EDGE_FALL) != 0){
+			xFalls++;
+		}
+	}
+	uint32_t xRises = 0;
+	uint32_t xFalls = 0;
+};
+
+/***
+ * Report a check
+ * @param name
+ * @param ok
+ * @return ok
+ */
+static bool check(const char *name, bool ok){
+	printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+	return ok;
+}
+
+int main(){
+	bool pass = true;
+	GPIOEdgeCounter falls;
+	EdgeRecorder rises;
+
+	pass = check("counter watches falls",
+			falls.watch(TEST_PAD, GPIO_IRQ_EDGE_FALL)) && pass;
+	pass = check("recorder watches rises",
+			GPIOInputMgr::getMgr()->addObserver(TEST_PAD, &rises,
+					GPIO_IRQ_EDGE_RISE)) && pass;
+	pass = check("pad interrupt enabled for both edges",
+			hostIrqEdges(TEST_PAD) == GPIO_EDGES_BOTH) && pass;
+
+	//Three presses, a release on its own and a fall and rise together
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_FALL);
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_RISE);
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_FALL);
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_RISE);
+	hostIrq(TEST_PAD, GPIO_EDGES_BOTH);
+	hostRunTask();
+
+	pass = check("counter saw only falls", falls.getCount(TEST_PAD) == 3) && pass;
+	pass = check("recorder saw only rises",
+			(rises.xRises == 3) && (rises.xFalls == 0)) && pass;
+	pass = check("all events dispatched",
+			GPIOInputMgr::getMgr()->getDispatched() == 5) && pass;
+
+	//Moving the recorder to falls leaves rises with no observer
+	GPIOInputMgr::getMgr()->addObserver(TEST_PAD, &rises, GPIO_IRQ_EDGE_FALL);
+	pass = check("rise interrupt disabled",
+			hostIrqEdges(TEST_PAD) == GPIO_IRQ_EDGE_FALL) && pass;
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_RISE);
+	hostIrq(TEST_PAD, GPIO_IRQ_EDGE_FALL);
+	hostRunTask();
+	pass = check("both see the fall",
+			(falls.getCount(TEST_PAD) == 4) && (rises.xFalls == 1) &&
+			(rises.xRises == 3)) && pass;
+
+	if (!pass){
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * hostStubs.cpp
+ *
+ * Host stand ins for the Pico SDK and FreeRTOS used by SwitchMgr and
+ * GPIOInputMgr
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "hostStubs.h"
+#include "hardware/gpio.h"
+#include "timers.h"
+#include "task.h"
+
+#define HOST_PADS 	32
+
+static bool xPads[HOST_PADS];
+static TimerCallbackFunction_t pTimerCB = NULL;
+static uint32_t xIrqEdges[HOST_PADS];
+static gpio_irq_callback_t pIrqCB = NULL;
+static TaskFunction_t pTaskCode = NULL;
+static void *pTaskParams = NULL;
+static uint32_t xNotifies = 0;
+static uint32_t xUs = 0;
+
+//Thrown to leave a task's run loop when it would wait for work
+struct HostStop {};
+
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period,
+		UBaseType_t autoReload, void *id, TimerCallbackFunction_t callback,
+		StaticTimer_t *buf){
+	pTimerCB = callback;
+	return (TimerHandle_t)buf;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait){
+	return pdTRUE;
+}
+
+void gpio_init(uint gpio){
+	xPads[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool out){
+}
+
+void gpio_pull_up(uint gpio){
+	xPads[gpio] = true;
+}
+
+bool gpio_get(uint gpio){
+	return xPads[gpio];
+}
+
+void hostSetPad(uint gpio, bool level){
+	xPads[gpio] = level;
+}
+
+void hostTick(){
+	if (pTimerCB != NULL){
+		pTimerCB(NULL);
+	}
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled){
+	if (enabled){
+		xIrqEdges[gpio] |= events;
+	} else {
+		xIrqEdges[gpio] &= ~events;
+	}
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events,
+		bool enabled, gpio_irq_callback_t callback){
+	pIrqCB = callback;
+	gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+uint32_t time_us_32(){
+	return xUs++;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+		configSTACK_DEPTH_TYPE depth, void *params, UBaseType_t priority,
+		TaskHandle_t *handle){
+	pTaskCode = code;
+	pTaskParams = params;
+	*handle = (TaskHandle_t)params;
+	return pdTRUE;
+}
+
+void vTaskDelete(TaskHandle_t task){
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task){
+	return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task){
+	xNotifies++;
+	return pdTRUE;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken){
+	xNotifies++;
+	*woken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait){
+	uint32_t n = xNotifies;
+	if (n == 0){
+		throw HostStop();
+	}
+	xNotifies = clear ? 0 : n - 1;
+	return n;
+}
+
+void hostIrq(uint gpio, uint32_t events){
+	events &= xIrqEdges[gpio];
+	if ((events != 0) && (pIrqCB != NULL)){
+		pIrqCB(gpio, events);
+	}
+}
+
+uint32_t hostIrqEdges(uint gpio){
+	return xIrqEdges[gpio];
+}
+
+void hostRunTask(){
+	if (pTaskCode == NULL){
+		return;
+	}
+	try {
+		pTaskCode(pTaskParams);
+	} catch (HostStop &){
+		// Waiting for work
+	}
+}
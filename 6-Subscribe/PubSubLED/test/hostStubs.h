@@ -0,0 +1,46 @@
+/*
+ * hostStubs.h
+ *
+ * Control of the host stand ins for the Pico SDK and FreeRTOS
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOSTSTUBS_H_
+#define _HOSTSTUBS_H_
+
+#include "pico/stdlib.h"
+
+/***
+ * Set the level a pad will read
+ * @param gpio - pad number
+ * @param level - true for high
+ */
+void hostSetPad(uint gpio, bool level);
+
+/***
+ * Fire the sample timer once, as if SWITCH_SAMPLE_MS had passed
+ */
+void hostTick();
+
+/***
+ * Raise a GPIO interrupt, if any of the events are enabled on the pad
+ * @param gpio - pad number
+ * @param events - GPIO_IRQ_EDGE_ mask
+ */
+void hostIrq(uint gpio, uint32_t events);
+
+/***
+ * Edges the interrupt is enabled for on a pad
+ * @param gpio - pad number
+ * @return GPIO_IRQ_EDGE_ mask
+ */
+uint32_t hostIrqEdges(uint gpio);
+
+/***
+ * Run the last task created until it waits for work
+ */
+void hostRunTask();
+
+#endif /* _HOSTSTUBS_H_ */
@@ -0,0 +1,39 @@
+/*
+ * FreeRTOS.h
+ *
+ * Host stand in for the parts of FreeRTOS used by SwitchMgr and
+ * GPIOInputMgr
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void * TimerHandle_t;
+typedef struct {int x;} StaticTimer_t;
+typedef void * TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define configSTACK_DEPTH_TYPE 	uint32_t
+#define configMAX_PRIORITIES 	32
+#define tskIDLE_PRIORITY 		0
+#define portMAX_DELAY 			0xFFFFFFFF
+#define portYIELD_FROM_ISR(x) 	(void)(x)
+
+#define pdTRUE 					1
+#define pdFALSE 				0
+#define pdPASS 					pdTRUE
+#define pdMS_TO_TICKS(ms) 		(ms)
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* _HOST_FREERTOS_H_ */
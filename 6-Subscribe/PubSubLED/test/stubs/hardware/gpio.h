@@ -0,0 +1,31 @@
+/*
+ * gpio.h
+ *
+ * Host stand in for the Pico SDK GPIO, pad levels are set by the test
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_HARDWARE_GPIO_H_
+#define _HOST_HARDWARE_GPIO_H_
+
+#include "pico/stdlib.h"
+
+#define GPIO_IN 	false
+#define GPIO_OUT 	true
+
+#define GPIO_IRQ_EDGE_FALL 	0x4u
+#define GPIO_IRQ_EDGE_RISE 	0x8u
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t events);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+bool gpio_get(uint gpio);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events,
+		bool enabled, gpio_irq_callback_t callback);
+
+#endif /* _HOST_HARDWARE_GPIO_H_ */
@@ -0,0 +1,25 @@
+/*
+ * stdlib.h
+ *
+ * Host stand in for the Pico SDK
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_PICO_STDLIB_H_
+#define _HOST_PICO_STDLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+
+#define __compiler_memory_barrier() 	__asm__ volatile ("" : : : "memory")
+
+uint32_t time_us_32();
+
+//As the SDK, stdlib brings in the GPIO API
+#include "hardware/gpio.h"
+
+#endif /* _HOST_PICO_STDLIB_H_ */
@@ -0,0 +1,25 @@
+/*
+ * task.h
+ *
+ * Host stand in for the FreeRTOS task API. The task created is not
+ * run until the test asks, and it stops when it would wait for work
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_TASK_H_
+#define _HOST_TASK_H_
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+		configSTACK_DEPTH_TYPE depth, void *params, UBaseType_t priority,
+		TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+
+#endif /* _HOST_TASK_H_ */
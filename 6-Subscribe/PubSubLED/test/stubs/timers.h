@@ -0,0 +1,24 @@
+/*
+ * timers.h
+ *
+ * Host stand in for FreeRTOS software timers. The test calls the
+ * callback itself, once per sample period
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_TIMERS_H_
+#define _HOST_TIMERS_H_
+
+#include "FreeRTOS.h"
+
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period,
+		UBaseType_t autoReload, void *id, TimerCallbackFunction_t callback,
+		StaticTimer_t *buf);
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait);
+
+#endif /* _HOST_TIMERS_H_ */
@@ -0,0 +1,153 @@
+/*
+ * switchTest.cpp
+ *
+ * Host simulation of SwitchMgr. Traces of pad levels are played through
+ * the shared sample timer and the observer events checked, with times
+ * in ms from the start of the trace.
+ *
+ * A trace is a list of segments of a level held for a time:
+ *   '-' released, '#' pressed, '~' bouncing, changes every sample
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "SwitchMgr.h"
+#include "hostStubs.h"
+#include <stdio.h>
+#include <string>
+
+struct TraceSeg {
+	char level;
+	uint32_t ms;
+};
+
+class TraceObserver : public SwitchObserver {
+public:
+	virtual void handleShortPress(uint8_t gp){
+		log("click", gp);
+	}
+	virtual void handleLongPress(uint8_t gp){
+		log("long", gp);
+	}
+	virtual void handleDoubleClick(uint8_t gp){
+		log("double", gp);
+	}
+	virtual void handleHoldStart(uint8_t gp){
+		log("hold", gp);
+	}
+	virtual void handleHoldRepeat(uint8_t gp, uint16_t count){
+		log(("repeat" + std::to_string(count)).c_str(), gp);
+	}
+
+	std::string xLog;
+	uint32_t xNow = 0;
+
+private:
+	void log(const char *ev, uint8_t gp){
+		if (!xLog.empty()){
+			xLog += " ";
+		}
+		xLog += std::to_string(gp) + ":" + ev + "@" + std::to_string(xNow);
+	}
+};
+
+static int xFailures = 0;
+
+/***
+ * Level of a trace at a sample
+ * @param segs - trace
+ * @param count - segments in trace
+ * @param sample - sample number
+ * @param pressed - set to whether the switch is pressed
+ * @return false once past the end of the trace
+ */
+static bool traceLevel(const TraceSeg *segs, size_t count, uint32_t sample,
+		bool *pressed){
+	uint32_t ms = sample * SWITCH_SAMPLE_MS;
+	for (size_t i=0; i < count; i++){
+		if (ms < segs[i].ms){
+			switch(segs[i].level){
+			case '#':
+				*pressed = true;
+				break;
+			case '~':
+				*pressed = (sample & 1) != 0;
+				break;
+			default:
+				*pressed = false;
+			}
+			return true;
+		}
+		ms -= segs[i].ms;
+	}
+	return false;
+}
+
+/***
+ * Play a trace on one switch and check the events and bounce count
+ * @param name - name for the report
+ * @param segs - trace
+ * @param count - segments in trace
+ * @param expect - expected events
+ * @param bounces - expected bounce count
+ */
+static void check(const char *name, const TraceSeg *segs, size_t count,
+		const char *expect, uint32_t bounces){
+	SwitchMgr sw(1);
+	TraceObserver obs;
+	sw.setObserver(&obs);
+
+	bool pressed;
+	for (uint32_t s=0; traceLevel(segs, count, s, &pressed); s++){
+		obs.xNow = s * SWITCH_SAMPLE_MS;
+		//Pulled up, so pressed reads low
+		hostSetPad(1, !pressed);
+		hostTick();
+	}
+
+	bool ok = (obs.xLog == expect) && (sw.getBounces() == bounces);
+	printf("%s %-8s %s, bounces %u\n", ok ? "PASS" : "FAIL", name,
+			obs.xLog.c_str(), sw.getBounces());
+	if (!ok){
+		printf("     expected %s, bounces %u\n", expect, bounces);
+		xFailures++;
+	}
+}
+
+#define CHECK(name, trace, expect, bounces) \
+	check(name, trace, sizeof(trace)/sizeof(TraceSeg), expect, bounces)
+
+int main(){
+	static const TraceSeg click[] = {
+		{'-', 50}, {'~', 20}, {'#', 100}, {'~', 15}, {'-', 500}
+	};
+	CHECK("click", click, "1:click@445", 2);
+
+	static const TraceSeg dbl[] = {
+		{'-', 50}, {'~', 10}, {'#', 80}, {'~', 10}, {'-', 100},
+		{'~', 10}, {'#', 80}, {'-', 400}
+	};
+	CHECK("double", dbl, "1:double@270", 1);
+
+	static const TraceSeg lng[] = {
+		{'-', 50}, {'#', 500}, {'~', 20}, {'-', 400}
+	};
+	CHECK("long", lng, "1:long@585", 2);
+
+	static const TraceSeg hold[] = {
+		{'-', 50}, {'#', 1700}, {'-', 400}
+	};
+	CHECK("hold", hold, "1:hold@1065 1:repeat1@1265 1:repeat2@1465 1:repeat3@1665", 0);
+
+	static const TraceSeg storm[] = {
+		{'-', 50}, {'~', 300}, {'-', 400}
+	};
+	CHECK("storm", storm, "", 30);
+
+	if (xFailures != 0){
+		printf("%d traces failed\n", xFailures);
+		return 1;
+	}
+	return 0;
+}
@@ -56,6 +56,24 @@ TaskHandle_t Agent::getTask(){
 	return xHandle;
 }
 
+/***
+ * Perform one non blocking step of the agent's work. Used when the
+ * agent is hosted by an AgentExecutor rather than its own task
+ * @return ticks until the next step, portMAX_DELAY if none is needed
+ */
+TickType_t Agent::step(){
+	return portMAX_DELAY;
+}
+
+/***
+ * Handle an event posted through an AgentExecutor
+ * @param event - application defined event code
+ * @return true if step should be called straight away
+ */
+bool Agent::handleEvent(uint32_t event){
+	return false;
+}
+
 
 /***
  * Start the task
@@ -56,6 +56,20 @@ public:
 	 */
 	virtual TaskHandle_t getTask();
 
+	/***
+	 * Perform one non blocking step of the agent's work. Used when the
+	 * agent is hosted by an AgentExecutor rather than its own task
+	 * @return ticks until the next step, portMAX_DELAY if none is needed
+	 */
+	virtual TickType_t step();
+
+	/***
+	 * Handle an event posted through an AgentExecutor
+	 * @param event - application defined event code
+	 * @return true if step should be called straight away
+	 */
+	virtual bool handleEvent(uint32_t event);
+
 protected:
 	/***
 	 * Start the task via static function
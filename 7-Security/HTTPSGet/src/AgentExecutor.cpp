@@ -0,0 +1,230 @@
+/*
+ * AgentExecutor.cpp
+ *
+ * Hosts many small agents on a single FreeRTOS task. Each hosted agent
+ * provides a non blocking step, which is called again after the delay
+ * it returns using a timer wheel. Events can be posted to hosted agents
+ * through a shared queue. A hosted agent costs a wheel entry rather than
+ * a TCB and stack of its own.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "AgentExecutor.h"
+#include <stdio.h>
+
+/***
+ * Constructor
+ */
+AgentExecutor::AgentExecutor() {
+	for (uint8_t i=0; i < AGENT_EXEC_SLOTS; i++){
+		xWheel[i] = -1;
+	}
+
+	xEventQ = xQueueCreateStatic( AGENT_EXEC_QUEUE_LEN,
+								  sizeof(AgentEvent),
+								  xEventQStorage,
+								  &xEventQStruct);
+	if (xEventQ == NULL){
+		printf("Unable to create executor queue\n");
+	}
+}
+
+/***
+ * Destructor
+ */
+AgentExecutor::~AgentExecutor() {
+	stop();
+}
+
+/***
+ * Host an agent, its first step is run once the executor starts.
+ * Must be called before start. The agent's own start must not be called
+ * @param agent
+ * @return false if the executor is full
+ */
+bool AgentExecutor::add(Agent *agent){
+	if (xCount >= AGENT_EXEC_MAX){
+		return false;
+	}
+	AgentEntry *e = &xEntries[xCount];
+	e->agent = agent;
+	e->next = -1;
+	e->scheduled = false;
+	xCount++;
+	return true;
+}
+
+/***
+ * Post an event to a hosted agent. Does not block
+ * @param agent - hosted agent
+ * @param event - application defined event code
+ * @return false if the queue is full
+ */
+bool AgentExecutor::post(Agent *agent, uint32_t event){
+	AgentEvent ev = {agent, event};
+	return (xQueueSendToBack(xEventQ, (void *)&ev, 0) == pdTRUE);
+}
+
+/***
+ * Post an event to a hosted agent from within an interrupt
+ * @param agent - hosted agent
+ * @param event - application defined event code
+ * @return false if the queue is full
+ */
+bool AgentExecutor::postFromISR(Agent *agent, uint32_t event){
+	AgentEvent ev = {agent, event};
+	BaseType_t woken = pdFALSE;
+	if (xQueueSendToBackFromISR(xEventQ, (void *)&ev, &woken) != pdTRUE){
+		return false;
+	}
+	portYIELD_FROM_ISR(woken);
+	return true;
+}
+
+/***
+ * Number of agents hosted
+ * @return
+ */
+uint8_t AgentExecutor::getCount(){
+	return xCount;
+}
+
+/***
+ * RAM used by the executor for each hosted agent, excluding
+ * the agent object itself
+ * @return bytes
+ */
+size_t AgentExecutor::getEntrySize(){
+	return sizeof(AgentEntry);
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE AgentExecutor::getMaxStackSize(){
+	return AGENT_EXEC_STACK;
+}
+
+/***
+ * Main Run Task for executor. Waits on the event queue until the
+ * next wheel slot is due, then runs the steps in that slot
+ */
+void AgentExecutor::run(){
+	AgentEvent ev;
+	TickType_t now = xTaskGetTickCount();
+
+	//Every agent takes its first step straight away
+	xCursor = now - (now % AGENT_EXEC_RES);
+	for (int8_t i=0; i < xCount; i++){
+		runStep(i, now);
+	}
+
+	while (true) { // Loop forever
+		now = xTaskGetTickCount();
+		TickType_t wait = 0;
+		TickType_t slotEnd = xCursor + AGENT_EXEC_RES - 1;
+		if ((int32_t)(slotEnd - now) > 0){
+			wait = slotEnd - now;
+		}
+
+		if (xQueueReceive(xEventQ, (void *)&ev, wait) == pdTRUE){
+			for (int8_t i=0; i < xCount; i++){
+				if (xEntries[i].agent == ev.agent){
+					if (ev.agent->handleEvent(ev.event)){
+						unschedule(i);
+						runStep(i, xTaskGetTickCount());
+					}
+					break;
+				}
+			}
+		}
+
+		advance(xTaskGetTickCount());
+	}
+}
+
+/***
+ * Wheel slot for a tick
+ * @param tick
+ * @return slot index
+ */
+uint8_t AgentExecutor::slotFor(TickType_t tick){
+	return (tick / AGENT_EXEC_RES) % AGENT_EXEC_SLOTS;
+}
+
+/***
+ * Place an entry on the wheel
+ * @param index - entry
+ * @param due - tick the step is due
+ */
+void AgentExecutor::schedule(int8_t index, TickType_t due){
+	uint8_t slot = slotFor(due);
+	xEntries[index].due = due;
+	xEntries[index].next = xWheel[slot];
+	xEntries[index].scheduled = true;
+	xWheel[slot] = index;
+}
+
+/***
+ * Remove an entry from the wheel
+ * @param index - entry
+ */
+void AgentExecutor::unschedule(int8_t index){
+	if (!xEntries[index].scheduled){
+		return;
+	}
+	int8_t *p = &xWheel[slotFor(xEntries[index].due)];
+	while (*p != -1){
+		if (*p == index){
+			*p = xEntries[index].next;
+			break;
+		}
+		p = &xEntries[*p].next;
+	}
+	xEntries[index].scheduled = false;
+}
+
+/***
+ * Run the step of an entry and reschedule it
+ * @param index - entry
+ * @param now - current tick
+ */
+void AgentExecutor::runStep(int8_t index, TickType_t now){
+	TickType_t delay = xEntries[index].agent->step();
+	if (delay == portMAX_DELAY){
+		xEntries[index].scheduled = false;
+		return;
+	}
+	if (delay == 0){
+		delay = 1;
+	}
+	schedule(index, now + delay);
+}
+
+/***
+ * Process all wheel slots whose time has fully passed. Entries due in a
+ * later turn of the wheel are put back in their slot
+ * @param now - current tick
+ */
+void AgentExecutor::advance(TickType_t now){
+	while ((int32_t)(now - (xCursor + AGENT_EXEC_RES - 1)) >= 0){
+		uint8_t slot = slotFor(xCursor);
+		int8_t index = xWheel[slot];
+		xWheel[slot] = -1;
+
+		while (index != -1){
+			int8_t next = xEntries[index].next;
+			xEntries[index].scheduled = false;
+			if ((int32_t)(xEntries[index].due - now) <= 0){
+				runStep(index, now);
+			} else {
+				schedule(index, xEntries[index].due);
+			}
+			index = next;
+		}
+		xCursor += AGENT_EXEC_RES;
+	}
+}
@@ -0,0 +1,164 @@
+/*
+ * AgentExecutor.h
+ *
+ * Hosts many small agents on a single FreeRTOS task. Each hosted agent
+ * provides a non blocking step, which is called again after the delay
+ * it returns using a timer wheel. Events can be posted to hosted agents
+ * through a shared queue. A hosted agent costs a wheel entry rather than
+ * a TCB and stack of its own.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _AGENTEXECUTOR_H_
+#define _AGENTEXECUTOR_H_
+
+#include "Agent.h"
+#include "queue.h"
+
+//Number of agents that can be hosted
+#ifndef AGENT_EXEC_MAX
+#define AGENT_EXEC_MAX 			16
+#endif
+
+//Wheel slots and the ticks covered by each slot, a step may run
+//up to AGENT_EXEC_RES - 1 ticks after it is due
+#ifndef AGENT_EXEC_SLOTS
+#define AGENT_EXEC_SLOTS 		32
+#endif
+
+#ifndef AGENT_EXEC_RES
+#define AGENT_EXEC_RES 			4
+#endif
+
+#ifndef AGENT_EXEC_QUEUE_LEN
+#define AGENT_EXEC_QUEUE_LEN 	8
+#endif
+
+#ifndef AGENT_EXEC_STACK
+#define AGENT_EXEC_STACK 		512
+#endif
+
+class AgentExecutor : public Agent {
+public:
+	/***
+	 * Constructor
+	 */
+	AgentExecutor();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~AgentExecutor();
+
+	/***
+	 * Host an agent, its first step is run once the executor starts.
+	 * Must be called before start. The agent's own start must not be called
+	 * @param agent
+	 * @return false if the executor is full
+	 */
+	bool add(Agent *agent);
+
+	/***
+	 * Post an event to a hosted agent. Does not block
+	 * @param agent - hosted agent
+	 * @param event - application defined event code
+	 * @return false if the queue is full
+	 */
+	bool post(Agent *agent, uint32_t event);
+
+	/***
+	 * Post an event to a hosted agent from within an interrupt
+	 * @param agent - hosted agent
+	 * @param event - application defined event code
+	 * @return false if the queue is full
+	 */
+	bool postFromISR(Agent *agent, uint32_t event);
+
+	/***
+	 * Number of agents hosted
+	 * @return
+	 */
+	uint8_t getCount();
+
+	/***
+	 * RAM used by the executor for each hosted agent, excluding
+	 * the agent object itself
+	 * @return bytes
+	 */
+	static size_t getEntrySize();
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	struct AgentEntry {
+		Agent *agent;
+		TickType_t due;
+		int8_t next;
+		bool scheduled;
+	};
+
+	struct AgentEvent {
+		Agent *agent;
+		uint32_t event;
+	};
+
+	/***
+	 * Place an entry on the wheel
+	 * @param index - entry
+	 * @param due - tick the step is due
+	 */
+	void schedule(int8_t index, TickType_t due);
+
+	/***
+	 * Remove an entry from the wheel
+	 * @param index - entry
+	 */
+	void unschedule(int8_t index);
+
+	/***
+	 * Run the step of an entry and reschedule it
+	 * @param index - entry
+	 * @param now - current tick
+	 */
+	void runStep(int8_t index, TickType_t now);
+
+	/***
+	 * Process all wheel slots whose time has fully passed
+	 * @param now - current tick
+	 */
+	void advance(TickType_t now);
+
+	/***
+	 * Wheel slot for a tick
+	 * @param tick
+	 * @return slot index
+	 */
+	static uint8_t slotFor(TickType_t tick);
+
+	AgentEntry xEntries[AGENT_EXEC_MAX];
+	uint8_t xCount = 0;
+
+	//Head entry of each slot, -1 for empty
+	int8_t xWheel[AGENT_EXEC_SLOTS];
+
+	//Start tick of the next slot to process
+	TickType_t xCursor = 0;
+
+	QueueHandle_t xEventQ = NULL;
+	uint8_t xEventQStorage[ AGENT_EXEC_QUEUE_LEN * sizeof(AgentEvent) ];
+	StaticQueue_t xEventQStruct;
+};
+
+#endif /* _AGENTEXECUTOR_H_ */
@@ -0,0 +1,92 @@
+/*
+ * CoAgent.cpp
+ *
+ * Stackless coroutine agent. A long sequential flow is written linearly
+ * in resume(), using the CO_ macros wherever it would block. Each wait
+ * returns to the caller with the resume point saved, so the flow can be
+ * hosted on an AgentExecutor and share its stack with other agents, or
+ * run on a task of its own.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CoAgent.h"
+
+/***
+ * Constructor
+ */
+CoAgent::CoAgent() {
+	// NOP
+}
+
+/***
+ * Destructor
+ */
+CoAgent::~CoAgent() {
+	// NOP
+}
+
+/***
+ * Resume the flow until its next wait
+ * @return ticks until the flow should be resumed, portMAX_DELAY if
+ * it is finished or waiting on an event
+ */
+TickType_t CoAgent::step(){
+	return resume();
+}
+
+/***
+ * Record an event bit for CO_AWAIT_EVENT
+ * @param event - event bits
+ * @return true so the flow is resumed straight away
+ */
+bool CoAgent::handleEvent(uint32_t event){
+	xCoEvents |= event;
+	return true;
+}
+
+/***
+ * Check if the flow has finished
+ * @return
+ */
+bool CoAgent::isDone(){
+	return (xCoLine < 0);
+}
+
+/***
+ * Consume event bits, those taken are left in xCoTaken
+ * @param bits - bits to check for
+ * @return true if any were set, they are then cleared
+ */
+bool CoAgent::takeEvent(uint32_t bits){
+	if ((xCoEvents & bits) != 0){
+		xCoTaken = xCoEvents & bits;
+		xCoEvents &= ~bits;
+		return true;
+	}
+	return false;
+}
+
+/***
+ * Task main run loop, used when the agent has a task of its own.
+ * Nothing posts events here so an event wait is only polled
+ */
+void CoAgent::run(){
+	TickType_t delay;
+
+	while (true) {
+		delay = step();
+		if (isDone()){
+			break;
+		}
+		if (delay == portMAX_DELAY){
+			delay = CO_POLL;
+		}
+		vTaskDelay(delay);
+	}
+
+	while (true) { // Loop forever
+		vTaskDelay(5000);
+	}
+}
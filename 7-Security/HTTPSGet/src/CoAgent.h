@@ -0,0 +1,124 @@
+/*
+ * CoAgent.h
+ *
+ * Stackless coroutine agent. A long sequential flow is written linearly
+ * in resume(), using the CO_ macros wherever it would block. Each wait
+ * returns to the caller with the resume point saved, so the flow can be
+ * hosted on an AgentExecutor and share its stack with other agents, or
+ * run on a task of its own.
+ *
+ * Locals do not survive a wait, keep any state needed across one in
+ * members. Only one CO_ wait may be used per source line. A call that
+ * blocks, such as the TLS handshake or a wolfSSL read, still blocks the
+ * whole executor, so such a flow keeps a task of its own.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _COAGENT_H_
+#define _COAGENT_H_
+
+#include "Agent.h"
+#include "queue.h"
+
+//Ticks between checks of a condition being awaited
+#ifndef CO_POLL
+#define CO_POLL 	10
+#endif
+
+//Start of the coroutine body in resume
+#define CO_BEGIN() \
+	if (xCoLine < 0) { return portMAX_DELAY; } \
+	switch (xCoLine) { case 0:
+
+//End of the coroutine body, the flow is finished
+#define CO_END() \
+	} xCoLine = -1; return portMAX_DELAY
+
+//Finish the flow early
+#define CO_EXIT() \
+	do { xCoLine = -1; return portMAX_DELAY; } while (0)
+
+//Wait for a number of ticks
+#define CO_DELAY(ticks) \
+	do { xCoLine = __LINE__; return (ticks); case __LINE__:; } while (0)
+
+//Wait until the condition is true, checked every CO_POLL ticks.
+//Used for transport readiness
+#define CO_AWAIT(cond) \
+	do { xCoLine = __LINE__; [[fallthrough]]; case __LINE__: \
+		if (!(cond)) { return CO_POLL; } } while (0)
+
+//Wait for an item from a queue
+#define CO_AWAIT_QUEUE(queue, item) \
+	CO_AWAIT(xQueueReceive((queue), (item), 0) == pdTRUE)
+
+//Wait for an event bit posted through AgentExecutor::post, such as
+//from the request complete callback of an agent on another task
+#define CO_AWAIT_EVENT(bits) \
+	do { xCoLine = __LINE__; [[fallthrough]]; case __LINE__: \
+		if (!takeEvent(bits)) { return portMAX_DELAY; } } while (0)
+
+class CoAgent : public Agent {
+public:
+	/***
+	 * Constructor
+	 */
+	CoAgent();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~CoAgent();
+
+	/***
+	 * Resume the flow until its next wait
+	 * @return ticks until the flow should be resumed, portMAX_DELAY if
+	 * it is finished or waiting on an event
+	 */
+	virtual TickType_t step();
+
+	/***
+	 * Record an event bit for CO_AWAIT_EVENT
+	 * @param event - event bits
+	 * @return true so the flow is resumed straight away
+	 */
+	virtual bool handleEvent(uint32_t event);
+
+	/***
+	 * Check if the flow has finished
+	 * @return
+	 */
+	bool isDone();
+
+protected:
+	/***
+	 * Task main run loop, used when the agent has a task of its own
+	 */
+	virtual void run();
+
+	/***
+	 * Coroutine body, written between CO_BEGIN and CO_END
+	 * @return ticks until the flow should be resumed
+	 */
+	virtual TickType_t resume() = 0;
+
+	/***
+	 * Consume event bits, those taken are left in xCoTaken
+	 * @param bits - bits to check for
+	 * @return true if any were set, they are then cleared
+	 */
+	bool takeEvent(uint32_t bits);
+
+	//Resume point, 0 at start and -1 once finished
+	int xCoLine = 0;
+
+	//Events posted but not yet consumed
+	uint32_t xCoEvents = 0;
+
+	//Events consumed by the last event wait
+	uint32_t xCoTaken = 0;
+};
+
+#endif /* _COAGENT_H_ */
@@ -0,0 +1,73 @@
+/*
+ * TestReport.cpp
+ *
+ * Hosted coroutine that waits for the completion events of the
+ * TestTrans requests and reports how long each took. Shows a flow
+ * on the AgentExecutor being resumed by a callback from another task.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TestReport.h"
+#include "TestTrans.h"
+#include <stdio.h>
+
+/***
+ * Constructor
+ */
+TestReport::TestReport() {
+	// NOP
+}
+
+/***
+ * Destructor
+ */
+TestReport::~TestReport() {
+	// NOP
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE TestReport::getMaxStackSize(){
+	return 256;
+}
+
+/***
+ * Milliseconds since xStart, restarting the count
+ * @return ms
+ */
+unsigned long TestReport::lap(){
+	TickType_t now = xTaskGetTickCount();
+	unsigned long ms = (unsigned long)(now - xStart) * portTICK_PERIOD_MS;
+	xStart = now;
+	return ms;
+}
+
+/***
+ * Report flow, wait for HEAD then GET to complete
+ * @return ticks until the flow should be resumed
+ */
+TickType_t TestReport::resume(){
+	CO_BEGIN();
+
+	xStart = xTaskGetTickCount();
+
+	CO_AWAIT_EVENT(TEST_TRANS_HEAD_DONE | TEST_TRANS_FAILED);
+	if ((xCoTaken & TEST_TRANS_FAILED) != 0){
+		printf("REPORT: test failed after %lu ms\n", lap());
+		CO_EXIT();
+	}
+	printf("REPORT: connect and HEAD took %lu ms\n", lap());
+
+	CO_AWAIT_EVENT(TEST_TRANS_GET_DONE | TEST_TRANS_FAILED);
+	if ((xCoTaken & TEST_TRANS_FAILED) != 0){
+		printf("REPORT: GET failed after %lu ms\n", lap());
+		CO_EXIT();
+	}
+	printf("REPORT: GET took %lu ms\n", lap());
+
+	CO_END();
+}
@@ -0,0 +1,53 @@
+/*
+ * TestReport.h
+ *
+ * Hosted coroutine that waits for the completion events of the
+ * TestTrans requests and reports how long each took. Shows a flow
+ * on the AgentExecutor being resumed by a callback from another task.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _TESTREPORT_H_
+#define _TESTREPORT_H_
+
+#include "CoAgent.h"
+
+class TestReport : public CoAgent {
+public:
+	/***
+	 * Constructor
+	 */
+	TestReport();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~TestReport();
+
+protected:
+	/***
+	 * Report flow, wait for HEAD then GET to complete
+	 * @return ticks until the flow should be resumed
+	 */
+	virtual TickType_t resume();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Milliseconds since xStart, restarting the count
+	 * @return ms
+	 */
+	unsigned long lap();
+
+	//Tick the current request started
+	TickType_t xStart = 0;
+};
+
+#endif /* _TESTREPORT_H_ */
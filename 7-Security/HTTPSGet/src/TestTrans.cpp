@@ -10,6 +10,15 @@
 #include "TCPTransport.h"
 #include "TLSTransBlock.h"
 
+#define TEST_HOST "drjonea.co.uk"
+#define TEST_HEAD "HEAD /test/ HTTP/1.1\r\n" \
+					"Host: drjonea.co.uk\r\n" \
+					"\r\n"
+#define TEST_GET "GET /test/ HTTP/1.1\r\n" \
+					"Host: drjonea.co.uk\r\n" \
+					"Connection: close\r\n" \
+					"\r\n"
+
 TestTrans::TestTrans() {
 	// TODO Auto-generated constructor stub
 
@@ -19,19 +28,28 @@ TestTrans::~TestTrans() {
 	// TODO Auto-generated destructor stub
 }
 
-void TestTrans::run(){
-
-	test();
-
-	printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
+/***
+ * Post TEST_TRANS_ events to a hosted agent as each request completes
+ * @param executor - executor hosting the agent
+ * @param agent - agent to notify
+ */
+void TestTrans::setCompleteTarget(AgentExecutor *executor, Agent *agent){
+	pExecutor = executor;
+	pTarget = agent;
+}
 
-	while (true) { // Loop forever
-		vTaskDelay(5000);
+/***
+ * Request complete callback, posts the event to the target agent
+ * @param event - TEST_TRANS_ event
+ */
+void TestTrans::requestComplete(uint32_t event){
+	if ((pExecutor != NULL) && (pTarget != NULL)){
+		if (!pExecutor->post(pTarget, event)){
+			printf("Executor queue full\n");
+		}
 	}
-
 }
 
-
 /***
 * Get the static depth required in words
 * @return - words
@@ -40,27 +58,6 @@ configSTACK_DEPTH_TYPE TestTrans::getMaxStackSize(){
 	return 5000;
 }
 
-void TestTrans::test(){
-
-	xTests++;
-	if (!testConnect()){
-		printf("CONNECTIONED FAILED\n");
-	} else {
-		xSuccessful++;
-	}
-
-	xTests++;
-	//if (!testTrans()){
-	if (!testTLS()){
-		printf("Trans FAILED\n");
-	} else {
-		xSuccessful++;
-	}
-
-
-}
-
-
 bool TestTrans::testConnect(){
 	if (WifiHelper::isJoined()) {
 		return true;
@@ -126,123 +123,134 @@ bool TestTrans::testTrans(){
 }
 
 
-bool TestTrans::testTLS(){
-	uint16_t targetPort = 443;
-	char targetHost[]="drjonea.co.uk";
-	char head[]="HEAD /test/ HTTP/1.1\r\n"
-					"Host: drjonea.co.uk\r\n"
-					"\r\n";
-	char get[]="GET /test/ HTTP/1.1\r\n"
-					"Host: drjonea.co.uk\r\n"
-					"Connection: close\r\n"
-					"\r\n";
-	NetworkContext_t net;
-	char buf[1024];
-	int32_t retVal;
-	int err;
-	int count=0;
-	int waitCount;
+/***
+ * Send a request over the TLS connection
+ * @param req - request string
+ * @return false if send failed
+ */
+bool TestTrans::sendTLS(const char *req){
+	xRetVal = xTLS.transSend(&xNet, req, strlen(req));
+	if (xRetVal != strlen(req)){
+		printf("Socket Send failed\n\r");
+		return false;
+	}
+	return true;
+}
 
-	TLSTransBlock sockTrans;
+/***
+ * Test flow, connect then TLS HEAD and GET requests.
+ * Written as a coroutine, but the TLS handshake and reads block and
+ * need a deep stack so it runs on a task of its own
+ * @return ticks until the flow should be resumed
+ */
+TickType_t TestTrans::resume(){
+	CO_BEGIN();
 
+	xTests++;
+	if (!testConnect()){
+		printf("CONNECTIONED FAILED\n");
+	} else {
+		xSuccessful++;
+	}
+
+	xTests++;
 	printf("Testing TLS\n");
 
-	if (!sockTrans.transConnect(targetHost, targetPort)){
+	if (!xTLS.transConnect(TEST_HOST, 443)){
 		printf("Socket Connect Failed\r\n");
-		return false;
+		printf("Trans FAILED\n");
+		printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
+		requestComplete(TEST_TRANS_FAILED);
+		CO_EXIT();
 	}
 
 	printf("Test TLS Connected \n");
 
 
 	//Check no data and nonblocking (1 byte read)
-	for (int i =0; i < 10; i++){
-		retVal = sockTrans.transRead(&net, buf, 1);
-		if (retVal != 0){
+	for (xLoop = 0; xLoop < 10; xLoop++){
+		xRetVal = xTLS.transRead(&xNet, xBuf, 1);
+		if (xRetVal != 0){
 			printf("Read data initially\n\r");
-			return false;
+			printf("Trans FAILED\n");
+			printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
+			requestComplete(TEST_TRANS_FAILED);
+			CO_EXIT();
 		}
-		vTaskDelay(200);
+		CO_DELAY(200);
 	}
 	printf("Test TLS Read No Data \n");
 
 
 	printf("#######HTTP HEAD START#######\n");
-	retVal = sockTrans.transSend(&net, head, strlen(head));
-	if (retVal != strlen(head)){
-		printf("Socket Send failed\n\r");
-		return false;
+	if (!sendTLS(TEST_HEAD)){
+		printf("Trans FAILED\n");
+		printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
+		requestComplete(TEST_TRANS_FAILED);
+		CO_EXIT();
 	}
 
-	retVal = 1;
-	waitCount = 0;
-	while (retVal >= 0) {
-		retVal = sockTrans.transRead(&net, buf, 1);
+	xRetVal = 1;
+	xWaitCount = 0;
+	while ((xRetVal >= 0) && (xWaitCount <= 10)) {
+		xRetVal = xTLS.transRead(&xNet, xBuf, 1);
 
-		if (retVal == 0){
-			waitCount ++;
-			vTaskDelay(300);
+		if (xRetVal == 0){
+			xWaitCount ++;
+			CO_DELAY(300);
 		} else {
-			retVal = sockTrans.transRead(&net, &buf[1], sizeof(buf)-1);
+			xRetVal = xTLS.transRead(&xNet, &xBuf[1], sizeof(xBuf)-1);
 
-			if (retVal > 0){
-				sockTrans.debugPrintBuffer("READ:", buf, retVal);
+			if (xRetVal > 0){
+				xTLS.debugPrintBuffer("READ:", xBuf, xRetVal);
 			}
 		}
-
-		if (waitCount > 10){
-			break;
-		}
-
-
 	}
 
 	printf("#######HTTP HEAD END#######\n");
+	requestComplete(TEST_TRANS_HEAD_DONE);
 
 
 	printf("#######HTTP GET START#######\n");
-	retVal = sockTrans.transSend(&net, get, strlen(get));
-	if (retVal != strlen(get)){
-		printf("Socket Send failed\n\r");
-		return false;
+	if (!sendTLS(TEST_GET)){
+		printf("Trans FAILED\n");
+		printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
+		requestComplete(TEST_TRANS_FAILED);
+		CO_EXIT();
 	}
 
-	retVal = 1;
-	waitCount = 0;
-	while (retVal >= 0) {
-		retVal = sockTrans.transRead(&net, buf, 1);
+	xRetVal = 1;
+	xWaitCount = 0;
+	xCount = 0;
+	while ((xRetVal >= 0) && (xWaitCount <= 10)) {
+		xRetVal = xTLS.transRead(&xNet, xBuf, 1);
 
-		if (retVal == 0){
-			waitCount ++;
-			vTaskDelay(300);
+		if (xRetVal == 0){
+			xWaitCount ++;
+			CO_DELAY(300);
 		} else {
-			retVal = sockTrans.transRead(&net, &buf[1], sizeof(buf)-1);
+			xRetVal = xTLS.transRead(&xNet, &xBuf[1], sizeof(xBuf)-1);
 
-			if (retVal > 0){
-				sockTrans.debugPrintBuffer("READ:", buf, retVal);
-				count = count + retVal;
+			if (xRetVal > 0){
+				xTLS.debugPrintBuffer("READ:", xBuf, xRetVal);
+				xCount = xCount + xRetVal;
 			}
 		}
 
-		if (waitCount > 10){
-			break;
-		}
-
-		if (count  > 2048){
+		if (xCount  > 2048){
 			printf("Truncating returned data\n");
 			break;
 		}
-
-
 	}
 
 	printf("#######HTTP GET END#######\n");
+	requestComplete(TEST_TRANS_GET_DONE);
 
 
-	sockTrans.transClose();
-
+	xTLS.transClose();
 
+	xSuccessful++;
+	printf("RUN %d TESTS, SUCESSFUL %d\n", xTests, xSuccessful);
 
-	return true;
+	CO_END();
 }
-
@@ -12,19 +12,36 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
-#include "Agent.h"
+#include "CoAgent.h"
+#include "AgentExecutor.h"
+#include "TLSTransBlock.h"
 
-class TestTrans : public Agent{
+//Events posted as each request completes
+#define TEST_TRANS_HEAD_DONE 	0x01
+#define TEST_TRANS_GET_DONE 	0x02
+#define TEST_TRANS_FAILED 		0x04
+
+class TestTrans : public CoAgent{
 public:
 	TestTrans();
 	virtual ~TestTrans();
 
+	/***
+	 * Post TEST_TRANS_ events to a hosted agent as each request completes
+	 * @param executor - executor hosting the agent
+	 * @param agent - agent to notify
+	 */
+	void setCompleteTarget(AgentExecutor *executor, Agent *agent);
+
 protected:
 
 	/***
-	 * Run loop for the agent.
+	 * Test flow, connect then TLS HEAD and GET requests.
+	 * Written as a coroutine, but the TLS handshake and reads block and
+	 * need a deep stack so it runs on a task of its own
+	 * @return ticks until the flow should be resumed
 	 */
-	virtual void run();
+	virtual TickType_t resume();
 
 
 	/***
@@ -33,16 +50,39 @@ protected:
 	 */
 	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
 
-	void test();
-
 private:
 
 	bool testConnect();
 	bool testTrans();
-	bool testTLS();
+
+	/***
+	 * Send a request over the TLS connection
+	 * @param req - request string
+	 * @return false if send failed
+	 */
+	bool sendTLS(const char *req);
+
+	/***
+	 * Request complete callback, posts the event to the target agent
+	 * @param event - TEST_TRANS_ event
+	 */
+	void requestComplete(uint32_t event);
+
+	//Agent told of completed requests
+	AgentExecutor *pExecutor = NULL;
+	Agent *pTarget = NULL;
 
 	int xTests = 0;
 	int xSuccessful = 0;
+
+	//TLS flow state, held here as it must survive each wait
+	TLSTransBlock xTLS;
+	NetworkContext_t xNet;
+	char xBuf[1024];
+	int32_t xRetVal = 0;
+	int xCount = 0;
+	int xWaitCount = 0;
+	int xLoop = 0;
 };
 
 #endif /* TEST_TESTTRANS_H_ */
@@ -21,6 +21,8 @@
 
 #include "WifiHelper.h"
 #include "TestTrans.h"
+#include "AgentExecutor.h"
+#include "TestReport.h"
 
 
 
@@ -127,8 +129,21 @@ void main_task(void *params){
 
 
 
-	TestTrans testTrans;
-	testTrans.start("test", TASK_PRIORITY);
+	//Test flow blocks in the TLS handshake and reads, so has a task and
+	//deep stack of its own. The report is hosted on the executor and is
+	//resumed by the test's request complete events
+	static AgentExecutor executor;
+	static TestTrans testTrans;
+	static TestReport testReport;
+	executor.add(&testReport);
+	testTrans.setCompleteTarget(&executor, &testReport);
+	executor.start("Executor", TASK_PRIORITY);
+	testTrans.start("TestTrans", TASK_PRIORITY);
+
+	printf("Hosted agent RAM %lu bytes, on its own task at least %lu bytes\n",
+			(unsigned long)(sizeof(TestReport) + AgentExecutor::getEntrySize()),
+			(unsigned long)(sizeof(TestReport) + sizeof(StaticTask_t) +
+				configMINIMAL_STACK_SIZE * sizeof(StackType_t)));
 
     while(true) {
 
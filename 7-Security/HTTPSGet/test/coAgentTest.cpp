@@ -0,0 +1,278 @@
+/*
+ * coAgentTest.cpp
+ *
+ * Host tests of CoAgent flows hosted on an AgentExecutor and run on a
+ * task of their own. Checks CO_DELAY and CO_AWAIT resume within the
+ * wheel resolution, CO_AWAIT_EVENT resumes straight away in posting
+ * order, CO_AWAIT_QUEUE, and that nothing after CO_EXIT is run.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hostStubs.h"
+#include "CoAgent.h"
+#include "AgentExecutor.h"
+
+#define EV_A 	0x01
+#define EV_B 	0x02
+
+#define TRACE_MAX 	32
+
+struct TraceEntry {
+	TickType_t tick;
+	const char *label;
+};
+
+static TraceEntry xTrace[TRACE_MAX];
+static int xTraceLen = 0;
+
+/***
+ * Record a point reached by a flow
+ * @param label
+ */
+static void trace(const char *label){
+	if (xTraceLen < TRACE_MAX){
+		xTrace[xTraceLen].tick = xTaskGetTickCount();
+		xTrace[xTraceLen].label = label;
+		xTraceLen++;
+	}
+}
+
+/***
+ * Flow using each of the waits, then exiting early
+ */
+class FlowAgent : public CoAgent {
+public:
+	bool xReady = false;
+	QueueHandle_t xQ = NULL;
+	uint32_t xResumes = 0;
+
+	FlowAgent(){
+		xQ = xQueueCreateStatic(2, sizeof(uint32_t), xQStorage, &xQStruct);
+	}
+
+protected:
+	virtual TickType_t resume(){
+		xResumes++;
+		CO_BEGIN();
+		trace("start");
+		CO_DELAY(20);
+		trace("delay");
+		CO_AWAIT(xReady);
+		trace("ready");
+		CO_AWAIT_EVENT(EV_A);
+		trace("eventA");
+		CO_AWAIT_EVENT(EV_B);
+		trace("eventB");
+		CO_AWAIT_QUEUE(xQ, &xItem);
+		trace("queue");
+		CO_EXIT();
+		trace("after exit");
+		CO_END();
+	}
+
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize(){
+		return 256;
+	}
+
+private:
+	uint32_t xItem = 0;
+	uint8_t xQStorage[2 * sizeof(uint32_t)];
+	StaticQueue_t xQStruct;
+};
+
+/***
+ * Flow delaying in a loop then running to CO_END
+ */
+class TickerAgent : public CoAgent {
+public:
+	//Expose the task run loop
+	void runTask(){
+		try {
+			run();
+		} catch (HostStop &){
+		}
+	}
+
+protected:
+	virtual TickType_t resume(){
+		CO_BEGIN();
+		for (xLoop = 0; xLoop < 4; xLoop++){
+			CO_DELAY(30);
+			trace("ticker");
+		}
+		CO_END();
+	}
+
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize(){
+		return 256;
+	}
+
+private:
+	int xLoop = 0;
+};
+
+/***
+ * Executor with its run loop exposed
+ */
+class HostExecutor : public AgentExecutor {
+public:
+	void runTask(){
+		try {
+			run();
+		} catch (HostStop &){
+		}
+	}
+};
+
+static HostExecutor *pExec = NULL;
+static FlowAgent *pFlow = NULL;
+
+//Resumes of the flow before the event posted after its exit
+static uint32_t xResumesAtPost = 0;
+
+/***
+ * Acts as the other tasks: sets the awaited condition, posts
+ * events B then A, sends to the queue and posts after the exit
+ * @param tick
+ */
+static void hostHook(TickType_t tick){
+	uint32_t item = 1;
+	switch (tick){
+	case 50:
+		pFlow->xReady = true;
+		break;
+	case 70:
+		pExec->post(pFlow, EV_B);
+		break;
+	case 80:
+		pExec->post(pFlow, EV_A);
+		break;
+	case 100:
+		xQueueSendToBack(pFlow->xQ, &item, 0);
+		break;
+	case 150:
+		xResumesAtPost = pFlow->xResumes;
+		pExec->post(pFlow, EV_A);
+		break;
+	}
+}
+
+/***
+ * Check the trace against the expected points, each within a window
+ * @param name - test name
+ * @param expect - expected labels and earliest ticks
+ * @param slack - ticks late each may be
+ * @param count - number expected
+ * @return true if matched
+ */
+static bool checkTrace(const char *name, const TraceEntry *expect,
+		const TickType_t *slack, int count){
+	bool pass = (xTraceLen == count);
+	for (int i=0; i < xTraceLen; i++){
+		printf("%s: %s@%lu\n", name, xTrace[i].label,
+				(unsigned long)xTrace[i].tick);
+		if ((i >= count) || (strcmp(xTrace[i].label, expect[i].label) != 0) ||
+				(xTrace[i].tick < expect[i].tick) ||
+				(xTrace[i].tick > expect[i].tick + slack[i])){
+			pass = false;
+		}
+	}
+	if (!pass){
+		printf("FAIL: %s trace does not match\n", name);
+	}
+	return pass;
+}
+
+/***
+ * Flow and ticker hosted on one executor
+ * @return true if passed
+ */
+static bool testHosted(){
+	static HostExecutor exec;
+	static FlowAgent flow;
+	static TickerAgent ticker;
+	pExec = &exec;
+	pFlow = &flow;
+	xTraceLen = 0;
+
+	exec.add(&flow);
+	exec.add(&ticker);
+	hostReset(hostHook, 200);
+	exec.runTask();
+
+	//A step may run up to AGENT_EXEC_RES - 1 ticks late, a polled
+	//condition up to a further CO_POLL. Events run as they arrive
+	const TickType_t res = AGENT_EXEC_RES - 1;
+	const TickType_t poll = CO_POLL + res;
+	const TraceEntry expect[] = {
+		{0, "start"},
+		{20, "delay"},
+		{30, "ticker"},
+		{50, "ready"},
+		{60, "ticker"},
+		{80, "eventA"},
+		{80, "eventB"},
+		{90, "ticker"},
+		{100, "queue"},
+		{120, "ticker"},
+	};
+	const TickType_t slack[] = {0, res, res, poll, 2 * res, 0, 0, 3 * res,
+		poll, 4 * res};
+	bool pass = checkTrace("hosted", expect, slack,
+			sizeof(expect) / sizeof(expect[0]));
+
+	if (!flow.isDone() || !ticker.isDone()){
+		printf("FAIL: hosted flows not done\n");
+		pass = false;
+	}
+
+	//The event posted after the exit resumes the flow once, which must
+	//return straight away and not be rescheduled
+	if (flow.xResumes != xResumesAtPost + 1){
+		printf("FAIL: finished flow resumed %lu times\n",
+				(unsigned long)(flow.xResumes - xResumesAtPost));
+		pass = false;
+	}
+	return pass;
+}
+
+/***
+ * Ticker on a task of its own
+ * @return true if passed
+ */
+static bool testOwnTask(){
+	TickerAgent ticker;
+	xTraceLen = 0;
+
+	hostReset(NULL, 200);
+	ticker.runTask();
+
+	const TraceEntry expect[] = {
+		{30, "ticker"},
+		{60, "ticker"},
+		{90, "ticker"},
+		{120, "ticker"},
+	};
+	const TickType_t slack[] = {0, 0, 0, 0};
+	bool pass = checkTrace("task", expect, slack,
+			sizeof(expect) / sizeof(expect[0]));
+	if (!ticker.isDone()){
+		printf("FAIL: task flow not done\n");
+		pass = false;
+	}
+	return pass;
+}
+
+int main(){
+	bool pass = testHosted();
+	pass = testOwnTask() && pass;
+	if (!pass){
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * hostStubs.cpp
+ *
+ * Host stand ins for the FreeRTOS task and queue API used by CoAgent
+ * and AgentExecutor. There is one thread, so a wait moves simulated
+ * time forward a tick at a time and calls the hook for each tick
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "hostStubs.h"
+#include "task.h"
+#include "queue.h"
+#include <string.h>
+
+static TickType_t xTick = 0;
+static TickType_t xLimit = 0;
+static HostTickHook pHook = NULL;
+
+void hostReset(HostTickHook hook, TickType_t limit){
+	xTick = 0;
+	xLimit = limit;
+	pHook = hook;
+	if (pHook != NULL){
+		pHook(xTick);
+	}
+}
+
+/***
+ * Move time on one tick
+ */
+static void hostAdvance(){
+	if (xTick >= xLimit){
+		throw HostStop();
+	}
+	xTick++;
+	if (pHook != NULL){
+		pHook(xTick);
+	}
+}
+
+TickType_t xTaskGetTickCount(){
+	return xTick;
+}
+
+void vTaskDelay(TickType_t ticks){
+	for (TickType_t i=0; i < ticks; i++){
+		hostAdvance();
+	}
+}
+
+void vTaskDelete(TaskHandle_t task){
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task){
+	return 0;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+		configSTACK_DEPTH_TYPE depth, void *params, UBaseType_t priority,
+		TaskHandle_t *handle){
+	return pdFALSE;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+		uint8_t *storage, StaticQueue_t *queue){
+	queue->storage = storage;
+	queue->length = length;
+	queue->itemSize = itemSize;
+	queue->head = 0;
+	queue->count = 0;
+	return queue;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item,
+		TickType_t wait){
+	if (queue->count >= queue->length){
+		return pdFALSE;
+	}
+	UBaseType_t tail = (queue->head + queue->count) % queue->length;
+	memcpy(&queue->storage[tail * queue->itemSize], item, queue->itemSize);
+	queue->count++;
+	return pdTRUE;
+}
+
+BaseType_t xQueueSendToBackFromISR(QueueHandle_t queue, const void *item,
+		BaseType_t *woken){
+	return xQueueSendToBack(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait){
+	TickType_t waited = 0;
+	while (queue->count == 0){
+		if (waited >= wait){
+			return pdFALSE;
+		}
+		hostAdvance();
+		waited++;
+	}
+	memcpy(item, &queue->storage[queue->head * queue->itemSize],
+			queue->itemSize);
+	queue->head = (queue->head + 1) % queue->length;
+	queue->count--;
+	return pdTRUE;
+}
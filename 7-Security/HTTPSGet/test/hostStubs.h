@@ -0,0 +1,29 @@
+/*
+ * hostStubs.h
+ *
+ * Control of the host stand ins for FreeRTOS. Time only moves when the
+ * code under test waits, so runs are repeatable
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOSTSTUBS_H_
+#define _HOSTSTUBS_H_
+
+#include "FreeRTOS.h"
+
+//Called for each simulated tick, to act as other tasks
+typedef void (*HostTickHook)(TickType_t tick);
+
+//Thrown from a wait once the run limit is passed
+struct HostStop {};
+
+/***
+ * Reset time to zero and set the hook called on each tick
+ * @param hook - NULL for none
+ * @param limit - tick at which the next wait throws HostStop
+ */
+void hostReset(HostTickHook hook, TickType_t limit);
+
+#endif /* _HOSTSTUBS_H_ */
@@ -0,0 +1,36 @@
+/*
+ * FreeRTOS.h
+ *
+ * Host stand in for the parts of FreeRTOS used by CoAgent and
+ * AgentExecutor
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define configSTACK_DEPTH_TYPE 	uint16_t
+
+#define pdTRUE 					1
+#define pdFALSE 				0
+#define pdPASS 					pdTRUE
+#define portMAX_DELAY 			((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 		1
+#define pdMS_TO_TICKS(ms) 		(ms)
+#define tskIDLE_PRIORITY 		0
+
+#define portYIELD_FROM_ISR(x) 	(void)(x)
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* _HOST_FREERTOS_H_ */
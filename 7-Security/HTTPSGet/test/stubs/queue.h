@@ -0,0 +1,33 @@
+/*
+ * queue.h
+ *
+ * Host stand in for the FreeRTOS static queue API
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_QUEUE_H_
+#define _HOST_QUEUE_H_
+
+#include "FreeRTOS.h"
+
+typedef struct {
+	uint8_t *storage;
+	UBaseType_t length;
+	UBaseType_t itemSize;
+	UBaseType_t head;
+	UBaseType_t count;
+} StaticQueue_t;
+
+typedef StaticQueue_t * QueueHandle_t;
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+		uint8_t *storage, StaticQueue_t *queue);
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item,
+		TickType_t wait);
+BaseType_t xQueueSendToBackFromISR(QueueHandle_t queue, const void *item,
+		BaseType_t *woken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+
+#endif /* _HOST_QUEUE_H_ */
@@ -0,0 +1,27 @@
+/*
+ * task.h
+ *
+ * Host stand in for the FreeRTOS task API. Time is simulated and
+ * only moves when the code under test waits
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_TASK_H_
+#define _HOST_TASK_H_
+
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelete(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+		configSTACK_DEPTH_TYPE depth, void *params, UBaseType_t priority,
+		TaskHandle_t *handle);
+
+#endif /* _HOST_TASK_H_ */
@@ -59,6 +59,8 @@ struct MQTTAgentCommandContext
 	char * topic;
 	void * payload;
 	MQTTAgentSubscribeArgs_t *subArgs;
+	void * agent;
+	bool windowed;
 };
 
 /*-----------------------------------------------------------*/
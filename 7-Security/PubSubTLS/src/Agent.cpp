@@ -56,6 +56,49 @@ TaskHandle_t Agent::getTask(){
 	return xHandle;
 }
 
+/***
+ * Wake the task, call once work has been queued for it.
+ * Uses the task's notification value as a count
+ */
+void Agent::wake(){
+	if (xHandle != NULL){
+		xTaskNotifyGive(xHandle);
+	}
+}
+
+/***
+ * Wake the task from within an interrupt
+ */
+void Agent::wakeFromISR(){
+	BaseType_t woken = pdFALSE;
+	if (xHandle != NULL){
+		vTaskNotifyGiveFromISR(xHandle, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+
+/***
+ * Block until woken by wake or wakeFromISR, so the run loop
+ * only uses CPU when there is work to do
+ * @param timeout - ticks to wait
+ * @return true if woken, false on timeout
+ */
+bool Agent::waitForWork(TickType_t timeout){
+	if (ulTaskNotifyTake(pdTRUE, timeout) > 0){
+		xWakes++;
+		return true;
+	}
+	return false;
+}
+
+/***
+ * Number of times the task has been woken to do work
+ * @return
+ */
+uint32_t Agent::getWakes(){
+	return xWakes;
+}
+
 
 /***
  * Start the task
@@ -71,6 +114,19 @@ bool Agent::start(const char *name, UBaseType_t priority){
 	} else {
 		strcpy(pName, name);
 	}
+	if ((getStaticStack() != NULL) && (getStaticTCB() != NULL)){
+		xHandle = xTaskCreateStatic(
+			Agent::vTask,
+			pName,
+			getMaxStackSize(),
+			( void * ) this,
+			priority,
+			getStaticStack(),
+			getStaticTCB()
+		);
+		return (xHandle != NULL);
+	}
+
 	res = xTaskCreate(
 			Agent::vTask,       /* Function that implements the task. */
 		pName,   /* Text name for the task. */
@@ -82,6 +138,24 @@ bool Agent::start(const char *name, UBaseType_t priority){
 	return (res == pdPASS);
 }
 
+/***
+ * Stack for a statically allocated task, of getMaxStackSize words.
+ * NULL to allocate the task from the heap
+ * @return
+ */
+StackType_t *Agent::getStaticStack(){
+	return NULL;
+}
+
+/***
+ * TCB for a statically allocated task
+ * NULL to allocate the task from the heap
+ * @return
+ */
+StaticTask_t *Agent::getStaticTCB(){
+	return NULL;
+}
+
 
 
 /***
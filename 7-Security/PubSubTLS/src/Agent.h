@@ -56,6 +56,23 @@ public:
 	 */
 	virtual TaskHandle_t getTask();
 
+	/***
+	 * Wake the task, call once work has been queued for it.
+	 * Uses the task's notification value as a count
+	 */
+	virtual void wake();
+
+	/***
+	 * Wake the task from within an interrupt
+	 */
+	virtual void wakeFromISR();
+
+	/***
+	 * Number of times the task has been woken to do work
+	 * @return
+	 */
+	uint32_t getWakes();
+
 protected:
 	/***
 	 * Start the task via static function
@@ -74,11 +91,36 @@ protected:
 	 */
 	virtual configSTACK_DEPTH_TYPE getMaxStackSize()=0;
 
+	/***
+	 * Stack for a statically allocated task, of getMaxStackSize words.
+	 * NULL to allocate the task from the heap
+	 * @return
+	 */
+	virtual StackType_t *getStaticStack();
+
+	/***
+	 * TCB for a statically allocated task
+	 * NULL to allocate the task from the heap
+	 * @return
+	 */
+	virtual StaticTask_t *getStaticTCB();
+
+	/***
+	 * Block until woken by wake or wakeFromISR, so the run loop
+	 * only uses CPU when there is work to do
+	 * @param timeout - ticks to wait
+	 * @return true if woken, false on timeout
+	 */
+	bool waitForWork(TickType_t timeout = portMAX_DELAY);
+
 	//The task
 	TaskHandle_t xHandle = NULL;
 
 	char pName[MAX_NAME_LEN];
 
+	//Count of wakes from waitForWork
+	uint32_t xWakes = 0;
+
 
 };
 
@@ -39,10 +39,22 @@ LEDAgent::LEDAgent(uint8_t ledGP, uint8_t spstGP, MQTTInterface *interface) {
 		LogError(("Unable to create Queue\n"));
 	}
 
-	//Construct a message buffer
-	xBuffer = xMessageBufferCreate(LED_BUFFER_LEN);
-	if (xBuffer == NULL){
-		LogError(("Buffer could not be allocated\n"));
+	//Construct the command slot pool
+	xFreeQ = xQueueCreateStatic( LED_CMD_SLOTS,
+								 sizeof(char *),
+								 xFreeQStorage,
+								 &xFreeQStruct);
+	xJsonQ = xQueueCreateStatic( LED_CMD_SLOTS,
+								 sizeof(char *),
+								 xJsonQStorage,
+								 &xJsonQStruct);
+	if ((xFreeQ == NULL) || (xJsonQ == NULL)){
+		LogError(("Command slots could not be allocated\n"));
+	} else {
+		for (uint8_t i=0; i < LED_CMD_SLOTS; i++){
+			char *slot = xSlots[i];
+			xQueueSendToBack(xFreeQ, &slot, 0);
+		}
 	}
 
 	//Construct the TOPIC for status messages
@@ -73,9 +85,6 @@ LEDAgent::~LEDAgent() {
 		vPortFree(pTopicLedState);
 		pTopicLedState = NULL;
 	}
-	if (xBuffer != NULL){
-		vMessageBufferDelete(xBuffer);
-	}
 }
 
 
@@ -110,6 +119,8 @@ void LEDAgent::setOn(bool on){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -122,6 +133,8 @@ void LEDAgent::toggle(){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -133,6 +146,8 @@ void LEDAgent::intToggle(){
 	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wakeFromISR();
 	}
 }
 
@@ -141,29 +156,20 @@ void LEDAgent::intToggle(){
   * Main Run Task for agent
   */
 void LEDAgent::run(){
-	BaseType_t res;
 	LEDAction action = LEDOff;
-	char jsonStr[LED_JSON_LEN];
-	size_t readLen;
+	char *jsonStr;
 
-	if (xCmdQ == NULL){
+	if ((xCmdQ == NULL) || (xJsonQ == NULL)){
 		return;
 	}
 
 	while (true) { // Loop forever
-		readLen = xMessageBufferReceive(
-						 xBuffer,
-				         jsonStr,
-						 LED_JSON_LEN,
-						 0
-				    );
-		if (readLen > 0){
-			jsonStr[readLen] = 0;
+		while (xQueueReceive(xJsonQ, (void *)&jsonStr, 0) == pdTRUE){
 	        parseJSON(jsonStr);
+	        xQueueSendToBack(xFreeQ, (void *)&jsonStr, 0);
 		}
 
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
+		while (xQueueReceive(xCmdQ, (void *)&action, 0) == pdTRUE){
 			switch(action){
 				case LEDOff:{
 					execLed(false);
@@ -178,8 +184,10 @@ void LEDAgent::run(){
 					break;
 				}
 			}
-			taskYIELD();
 		}
+
+		//Sleep until more work is queued
+		waitForWork();
 	}
 }
 
@@ -192,32 +200,40 @@ void LEDAgent::execLed(bool state){
 	xState = state;
 	gpio_put(xLedGP, xState);
 
-	char payload[16];
-	if (xState){
-		sprintf(payload, "{\"on\"=True}");
-	} else {
-		sprintf(payload, "{\"on\"=False}");
-	}
 	if (pInterface != NULL){
-		pInterface->pubToTopic(
+		pInterface->pubToTopicWriter(
 			pTopicLedState,
-			payload,
-			strlen(payload),
+			LED_STATE_LEN,
+			LEDAgent::writeState,
+			this,
 			1,
 			false
 			);
 	}
 }
 
-
-
 /***
- * Get the static depth required in words
- * @return - words
+ * Write the LED state payload straight into the publish buffer
+ * @param ctx - LEDAgent
+ * @param buf - buffer to write to
+ * @param len - size of buffer
+ * @return length of payload, MQTT_WRITER_ABANDON if it does not fit
  */
- configSTACK_DEPTH_TYPE LEDAgent::getMaxStackSize(){
-	 return 250;
- }
+size_t LEDAgent::writeState(void *ctx, void *buf, size_t len){
+	LEDAgent *agent = (LEDAgent *)ctx;
+	int res;
+	if (agent->xState){
+		res = snprintf((char *)buf, len, "{\"on\"=True}");
+	} else {
+		res = snprintf((char *)buf, len, "{\"on\"=False}");
+	}
+	if ((res <= 0) || ((size_t)res >= len)){
+		return MQTT_WRITER_ABANDON;
+	}
+	return res;
+}
+
+
 
 
 /***
@@ -242,19 +258,33 @@ void LEDAgent::parseJSON(char *str){
 
 
 /***
- * Add a JSON string action
- * @param jsonStr
+ * Add a JSON string action. Copied once into a command slot
+ * which is parsed in place by the agent
+ * @param jsonStr - JSON, need not be terminated
+ * @param len - length of JSON, up to LED_CMD_LEN
  */
 void LEDAgent::addJSON(const void  *jsonStr, size_t len){
-	if (xBuffer != NULL){
-		size_t res = xMessageBufferSend(
-			xBuffer,
-			jsonStr,
-			len,
-			0);
-
-		if (res != len){
-			LogError(("Failed to write"));
-		}
+	char *slot;
+
+	if (xFreeQ == NULL){
+		return;
+	}
+	if (len > LED_CMD_LEN){
+		LogError(("JSON too long %d", len));
+		return;
+	}
+	if (xQueueReceive(xFreeQ, (void *)&slot, 0) != pdTRUE){
+		LogWarn(("No free command slot\n"));
+		return;
+	}
+
+	memcpy(slot, jsonStr, len);
+	slot[len] = 0;
+
+	if (xQueueSendToBack(xJsonQ, (void *)&slot, 0) != pdTRUE){
+		LogError(("Failed to write"));
+		xQueueSendToBack(xFreeQ, (void *)&slot, 0);
+	} else {
+		wake();
 	}
 }
@@ -11,25 +11,38 @@
 #define _LEDAGENT_H_
 
 
-#include "Agent.h"
+#include "StaticAgent.h"
 #include "SwitchObserver.h"
 #include "SwitchMgr.h"
 #include "tiny-json.h"
 
 #include "pico/stdlib.h"
 #include "queue.h"
-#include "message_buffer.h"
 #include "MQTTConfig.h"
 #include "MQTTInterface.h"
 
 #define LED_QUEUE_LEN 	5
+
+//Task stack in words
+#ifndef LED_AGENT_STACK
+#define LED_AGENT_STACK 	250
+#endif
 #define MQTT_TOPIC_LED_STATE "LED/state"
-#define LED_BUFFER_LEN 	256
-#define LED_JSON_LEN 	20
 #define LED_JSON_POOL 	5
+#define LED_STATE_LEN 	16
+
+//Largest JSON command accepted, excluding terminator
+#ifndef LED_CMD_LEN
+#define LED_CMD_LEN 	256
+#endif
+
+//Number of command slots that can be waiting for the agent
+#ifndef LED_CMD_SLOTS
+#define LED_CMD_SLOTS 	4
+#endif
 
 
-class LEDAgent : public Agent, public SwitchObserver {
+class LEDAgent : public StaticAgent<LED_AGENT_STACK>, public SwitchObserver {
 public:
 	/***
 	 * Constructor
@@ -57,8 +70,10 @@ public:
 
 
 	/***
-	 * Add a JSON string action
-	 * @param jsonStr
+	 * Add a JSON string action. Copied once into a command slot
+	 * which is parsed in place by the agent
+	 * @param jsonStr - JSON, need not be terminated
+	 * @param len - length of JSON, up to LED_CMD_LEN
 	 */
 	void addJSON(const void  *jsonStr, size_t len);
 
@@ -80,12 +95,6 @@ protected:
 	 */
 	virtual void run();
 
-	/***
-	 * Get the static depth required in words
-	 * @return - words
-	 */
-	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
-
 private:
 	/***
 	 * Toggle LED state from within an intrupt
@@ -98,6 +107,15 @@ private:
 	 */
 	void execLed(bool state);
 
+	/***
+	 * Write the LED state payload straight into the publish buffer
+	 * @param ctx - LEDAgent
+	 * @param buf - buffer to write to
+	 * @param len - size of buffer
+	 * @return length of payload
+	 */
+	static size_t writeState(void *ctx, void *buf, size_t len);
+
 	/***
 	 * Parse a JSON string and add request to queue
 	 * @param str - JSON Strging
@@ -124,8 +142,14 @@ private:
 	//Queue of commands
 	QueueHandle_t xCmdQ;
 
-	// Message buffer handle
-	MessageBufferHandle_t xBuffer = NULL;
+	// JSON command slots. Free slots sit on xFreeQ, filled ones on xJsonQ
+	char xSlots[LED_CMD_SLOTS][LED_CMD_LEN + 1];
+	QueueHandle_t xFreeQ = NULL;
+	uint8_t xFreeQStorage[ LED_CMD_SLOTS * sizeof(char *) ];
+	StaticQueue_t xFreeQStruct;
+	QueueHandle_t xJsonQ = NULL;
+	uint8_t xJsonQStorage[ LED_CMD_SLOTS * sizeof(char *) ];
+	StaticQueue_t xJsonQStruct;
 
 	// Json decoding buffer
 	json_t pJsonPool[ LED_JSON_POOL ];
@@ -59,7 +59,7 @@ void MQTTAgent::setTransport(Transport *t){
 MQTTStatus_t MQTTAgent::init(){
 	TransportInterface_t xTransport;
 	MQTTStatus_t xReturn;
-	MQTTFixedBuffer_t xFixedBuffer = { .pBuffer = xNetworkBuffer, .size = MQTT_AGENT_NETWORK_BUFFER_SIZE };
+	MQTTFixedBuffer_t xFixedBuffer = { .pBuffer = xNetworkBuffer, .size = MQTT_AGENT_RX_BUFFER_SIZE };
 
 
 	MQTTAgentMessageInterface_t messageInterface =
@@ -88,11 +88,32 @@ MQTTStatus_t MQTTAgent::init(){
 	Agent_InitializePool();
 
 	// Fill in Transforp interface
-	xNetworkContext.mqttTask = NULL;
+	xNetworkContext.mqttTask = this;
 	xNetworkContext.tcpTransport = pTrans;
 	xTransport.pNetworkContext = &xNetworkContext;
-	xTransport.send = Transport::staticSend;
-	xTransport.recv = Transport::staticRead;
+	xTransport.send = MQTTAgent::staticSend;
+	if (xStreamRecv){
+		xTransport.recv = MQTTAgent::streamRead;
+	} else {
+		xTransport.recv = MQTTAgent::staticRead;
+	}
+
+	if (xInflight == NULL){
+		xInflight = xSemaphoreCreateCountingStatic(MQTT_AGENT_MAX_INFLIGHT,
+				MQTT_AGENT_MAX_INFLIGHT, &xInflightStruct);
+	}
+
+	if (xTxRing){
+		xTxBuffer = xStreamBufferCreateStatic( MQTT_AGENT_TX_BUFFER_SIZE,
+											   1,
+											   xTxStorage,
+											   &xTxStruct);
+		xTransLock = xSemaphoreCreateMutexStatic(&xTransLockStruct);
+		if ((xTxBuffer == NULL) || (xTransLock == NULL)){
+			LogError(("MQTTAgent::init TX ring not initialised"));
+			return MQTTIllegalState;
+		}
+	}
 
 
 	/* Initialize MQTT library. */
@@ -178,6 +199,42 @@ void MQTTAgent::credentials(const char * user, const char * passwd, const char *
 
 }
 
+/***
+ * Turn on streamed receive. Publish messages too large for the network
+ * buffer are passed to the router in chunks through routeStream
+ * Must be called before start
+ * @param stream - true to turn on
+ */
+void MQTTAgent::setStreamRecv(bool stream){
+	xStreamRecv = stream;
+}
+
+/***
+ * Turn on the transmit ring. Outgoing packets are copied to a ring
+ * buffer and written to the transport by a separate task
+ * Must be called before start
+ * @param ring - true to turn on
+ */
+void MQTTAgent::setTxRing(bool ring){
+	xTxRing = ring;
+}
+
+/***
+ * Total bytes written to the transport
+ * @return
+ */
+uint32_t MQTTAgent::getTxBytes(){
+	return xTxBytes;
+}
+
+/***
+ * Total bytes read from the transport
+ * @return
+ */
+uint32_t MQTTAgent::getRxBytes(){
+	return xRxBytes;
+}
+
 /***
  * Connect to mqtt server
  * @param target - hostname or ip address, Not copied so pointer must remain valid
@@ -202,14 +259,47 @@ bool MQTTAgent::mqttConnect(const char * target, uint16_t  port, bool recon){
 *  */
 void MQTTAgent::start(UBaseType_t priority){
 	if (init() == MQTTSuccess){
+#if MQTT_AGENT_STATIC_TASKS
+		if (xTxRing){
+			xTxHandle = xTaskCreateStatic(
+				MQTTAgent::vTxTask,
+				"MQTTAgentTx",
+				MQTT_AGENT_TX_STACK,
+				( void * ) this,
+				priority,
+				xTxStack,
+				&xTxTCB
+			);
+		}
+		xHandle = xTaskCreateStatic(
+			MQTTAgent::vTask,
+			"MQTTAgent",
+			MQTT_AGENT_STACK,
+			( void * ) this,
+			priority,
+			xStack,
+			&xTCB
+		);
+#else
+		if (xTxRing){
+			xTaskCreate(
+				MQTTAgent::vTxTask,
+				"MQTTAgentTx",
+				MQTT_AGENT_TX_STACK,
+				( void * ) this,
+				priority,
+				&xTxHandle
+			);
+		}
 		xTaskCreate(
 			MQTTAgent::vTask,
 			"MQTTAgent",
-			2512,
+			MQTT_AGENT_STACK,
 			( void * ) this,
 			priority,
 			&xHandle
 		);
+#endif
 	}
 }
 
@@ -283,7 +373,7 @@ void MQTTAgent::start(UBaseType_t priority){
 				// Need to close socket connection.
 				//Platform_DisconnectNetwork( mqttAgentContext.mqttContext.transportInterface.pNetworkContext );
 				 LogDebug(("MQTT Closed\n"));
-				 pTrans->transClose();
+				 netClose();
 				 setConnState(Offline);
 			 }
 			 else if( status == MQTTSuccess )
@@ -294,7 +384,7 @@ void MQTTAgent::start(UBaseType_t priority){
 				status = MQTT_Disconnect( &( xGlobalMqttAgentContext.mqttContext ) );
 				//assert( status == MQTTSuccess );
 				//Platform_DisconnectNetwork( mqttAgentContext.mqttContext.transportInterface.pNetworkContext );
-				pTrans->transClose();
+				netClose();
 				setConnState(Offline);
 			 }
 			 else
@@ -308,7 +398,7 @@ void MQTTAgent::start(UBaseType_t priority){
 		 }
 		 case MQTTRecon:{
 			 if (WifiHelper::isJoined()){
-				 pTrans->transClose();
+				 netClose();
 			 }
 			 vTaskDelay(MQTT_RECON_DELAY);
 			 setConnState(TCPReq);
@@ -347,7 +437,7 @@ const char * MQTTAgent::getId(){
 * Close connection
 */
 void MQTTAgent::close(){
-	pTrans->transClose();
+	netClose();
 	xRecon=false;
 	setConnState(Offline);
 }
@@ -431,6 +521,13 @@ MQTTStatus_t  MQTTAgent::MQTTconn(){
 bool MQTTAgent::TCPconn(){
 	LogDebug(("TCP Connect...."));
 	if (pTrans->transConnect(pTarget, xPort)){
+		streamReset();
+		//Clean session so nothing is still waiting for an ack
+		if (xInflight != NULL){
+			while (xSemaphoreGive(xInflight) == pdTRUE){
+				;
+			}
+		}
 		setConnState(TCPConned);
 		LogDebug(("TCP Connected"));
 		return true;
@@ -457,13 +554,17 @@ void MQTTAgent::setObserver(MQTTAgentObserver *obs){
  */
 void MQTTAgent::stop(){
 	if (xConnState != Offline){
-		pTrans->transClose();
+		netClose();
 		setConnState(Offline);
 	}
 	if (xHandle != NULL){
 		vTaskDelete(  xHandle );
 		xHandle = NULL;
 	}
+	if (xTxHandle != NULL){
+		vTaskDelete(  xTxHandle );
+		xTxHandle = NULL;
+	}
 }
 
 /***
@@ -512,43 +613,107 @@ unsigned int MQTTAgent::getStakHighWater(){
 		return 0;
 }
 
+//Payload held by pubToTopic while it is copied in by the writer
+struct MQTTAgentPayload {
+	const void *payload;
+	size_t payloadLen;
+};
+
+/***
+ * Payload writer that copies a memory block
+ * @param ctx - MQTTAgentPayload
+ * @param buf - buffer to write to
+ * @param len - size of buffer
+ * @return bytes written
+ */
+static size_t copyPayload(void *ctx, void *buf, size_t len){
+	MQTTAgentPayload *p = (MQTTAgentPayload *)ctx;
+	memcpy(buf, p->payload, p->payloadLen);
+	return p->payloadLen;
+}
+
 /***
  * Publish message to topic
- * @param topic - zero terminated string. Copied by function
+ * Payload is copied straight into the publish buffer
+ * @param topic - topic with explicit length. Copied by function
  * @param payload - payload as pointer to memory block
  * @param payloadLen - length of memory block
  * @param QoS - quality of service - 0, 1 or 2
  * @param retain - ask broker to retain message
  */
-bool MQTTAgent::pubToTopic(const char * topic, const void * payload,
+bool MQTTAgent::pubToTopic(std::string_view topic, const void * payload,
 	size_t payloadLen, const uint8_t QoS, bool retain){
+	MQTTAgentPayload p = {payload, payloadLen};
+	return pubToTopicWriter(topic, payloadLen, copyPayload, &p, QoS, retain);
+}
+
+/***
+ * Publish message to topic with the payload written by a callback
+ * directly into the publish buffer held until the agent sends it.
+ * Topic and payload share a single block with the command
+ * context, so only one allocation is made per publish
+ * @param topic - topic with explicit length. Copied by function
+ * @param maxLen - most bytes the writer may produce
+ * @param writer - called once, before return, to write the payload
+ * @param ctx - passed to writer
+ * @param QoS - quality of service - 0, 1 or 2
+ * @param retain - ask broker to retain message
+ * @return false if writer abandoned or publish failed
+ */
+bool MQTTAgent::pubToTopicWriter(std::string_view topic, size_t maxLen,
+		MQTTPayloadWriter writer, void *ctx, const uint8_t QoS, bool retain){
 
 	MQTTStatus_t status;
+	size_t remLen;
+	size_t hdrLen;
 
 	// Fill command
 	MQTTAgentCommandInfo_t xCommandInfo;
 	xCommandInfo.cmdCompleteCallback = MQTTAgent::publishCmdCompleteCb;
 	xCommandInfo.blockTimeMs = 500;
 
-	MQTTAgentCommandContext_t* pCmdCBContext = (MQTTAgentCommandContext_t*) pvPortMalloc(sizeof(MQTTAgentCommandContext_t));
-	if (pCmdCBContext == NULL){
-		LogError(("malloc failed"));
-		return false;
+	//Wait for room in the in flight window. The agent task processes the
+	//acks that free the window, so it must not wait and its own publishes
+	//go outside the window when it is full
+	bool windowed = false;
+	if (xInflight != NULL){
+		bool onAgent = (xTaskGetCurrentTaskHandle() == xHandle);
+		TickType_t wait = onAgent ? 0 : pdMS_TO_TICKS(xCommandInfo.blockTimeMs);
+		if (xSemaphoreTake(xInflight, wait) == pdTRUE){
+			windowed = true;
+		} else if (!onAgent){
+			LogWarn(("publish window full"));
+			return false;
+		}
 	}
 
-	pCmdCBContext->topic = (char *)pvPortMalloc(strlen(topic)+1);
-	if (pCmdCBContext->topic == NULL){
+	MQTTAgentCommandContext_t* pCmdCBContext = (MQTTAgentCommandContext_t*) pvPortMalloc(
+			sizeof(MQTTAgentCommandContext_t) + topic.size() + maxLen);
+	if (pCmdCBContext == NULL){
 		LogError(("malloc failed"));
+		if (windowed){
+			xSemaphoreGive(xInflight);
+		}
 		return false;
 	}
-	strcpy(pCmdCBContext->topic,topic);
-
-	pCmdCBContext->payload = pvPortMalloc(payloadLen);
-	if (pCmdCBContext->payload == NULL){
-		LogError(("malloc failed"));
+	pCmdCBContext->agent = this;
+	pCmdCBContext->windowed = windowed;
+
+	pCmdCBContext->topic = (char *)(pCmdCBContext + 1);
+	memcpy(pCmdCBContext->topic, topic.data(), topic.size());
+
+	//Payload is written in place, after the topic
+	pCmdCBContext->payload = pCmdCBContext->topic + topic.size();
+	size_t payloadLen = writer(ctx, pCmdCBContext->payload, maxLen);
+	//Zero length is a valid payload, anything over maxLen is abandoned
+	if (payloadLen > maxLen){
+		LogError(("payload writer failed"));
+		vPortFree(pCmdCBContext);
+		if (windowed){
+			xSemaphoreGive(xInflight);
+		}
 		return false;
 	}
-	memcpy(pCmdCBContext->payload, payload, payloadLen);
 	xCommandInfo.pCmdCompleteCallbackContext = pCmdCBContext;
 
 
@@ -556,7 +721,7 @@ bool MQTTAgent::pubToTopic(const char * topic, const void * payload,
 	MQTTPublishInfo_t * pPublishInfo = &(pCmdCBContext->publishInfo);
 	pPublishInfo->qos = MQTTQoS1;
 	pPublishInfo->pTopicName = pCmdCBContext->topic;
-	pPublishInfo->topicNameLength = strlen(pCmdCBContext->topic);
+	pPublishInfo->topicNameLength = topic.size();
 	pPublishInfo->pPayload = pCmdCBContext->payload;
 	pPublishInfo->payloadLength = payloadLen;
 	pPublishInfo->retain = retain;
@@ -564,11 +729,30 @@ bool MQTTAgent::pubToTopic(const char * topic, const void * payload,
 	status = MQTTAgent_Publish( &xGlobalMqttAgentContext, pPublishInfo, &xCommandInfo );
 	if (status != MQTTSuccess ){
 		LogError(("publish error %d", status));
+		vPortFree(pCmdCBContext);
+		if (windowed){
+			xSemaphoreGive(xInflight);
+		}
 		return false;
 	} else {
 		//LogInfo(("Publish Complete"));
 	}
 
+	//Header is topic length and topic, plus packet id for QoS1/2
+	hdrLen = 2 + topic.size();
+	if (pPublishInfo->qos != MQTTQoS0){
+		hdrLen += 2;
+	}
+	remLen = hdrLen + payloadLen;
+	hdrLen += 2;
+	while (remLen > 127){
+		hdrLen++;
+		remLen = remLen >> 7;
+	}
+	xPubCount++;
+	xPubHeaderBytes += hdrLen;
+	xPubPayloadBytes += payloadLen;
+
 	if (pObserver != NULL){
 		pObserver->MQTTSend();
 	}
@@ -578,24 +762,29 @@ bool MQTTAgent::pubToTopic(const char * topic, const void * payload,
 
 /***
 * Call back function when Publish completes
+* Topic and payload share the context allocation
+* Frees a place in the in flight window if the publish took one
 * @param pCmdCallbackContext
 * @param pReturnInfo
 */
 void MQTTAgent::publishCmdCompleteCb( MQTTAgentCommandContext_t * pCmdCallbackContext,
             MQTTAgentReturnInfo_t * pReturnInfo ){
-	vPortFree(pCmdCallbackContext->topic);
-	vPortFree(pCmdCallbackContext->payload);
+	MQTTAgent *agent = (MQTTAgent *)pCmdCallbackContext->agent;
+	bool windowed = pCmdCallbackContext->windowed;
 	vPortFree(pCmdCallbackContext);
+	if (windowed && (agent != NULL) && (agent->xInflight != NULL)){
+		xSemaphoreGive(agent->xInflight);
+	}
 }
 
 
 /***
  * Subscribe to a topic, mesg will be sent to router object
- * @param topic
+ * @param topic - topic with explicit length. Not copied so must remain valid
  * @param QoS
  * @return
  */
-bool MQTTAgent::subToTopic(const char * topic,  const uint8_t QoS){
+bool MQTTAgent::subToTopic(std::string_view topic,  const uint8_t QoS){
 	MQTTStatus_t status = MQTTNoDataAvailable ;
 
 	// Fill the command information.
@@ -644,8 +833,8 @@ bool MQTTAgent::subToTopic(const char * topic,  const uint8_t QoS){
 		break;
 	}
 	}
-	pSubInfo->pTopicFilter = topic;
-	pSubInfo->topicFilterLength = strlen(topic);
+	pSubInfo->pTopicFilter = topic.data();
+	pSubInfo->topicFilterLength = topic.size();
 	pSubArgs->pSubscribeInfo = pSubInfo;
 	pSubArgs->numSubscriptions = 1U;
 
@@ -710,10 +899,507 @@ void MQTTAgent::setRouter( MQTTRouter *pRouter) {
 */
 void MQTTAgent::route(const char * topic, size_t topicLen, const void * payload, size_t payloadLen){
 	if (pRouter != NULL){
+		uint32_t start = time_us_32();
 		pRouter->route(topic, topicLen, payload, payloadLen, this);
+		uint32_t stall = time_us_32() - start;
+
+		xRouteTimeTotal += stall;
+		xRouteCount++;
+		if (stall > xRouteTimeMax){
+			xRouteTimeMax = stall;
+		}
 	}
 	if (pObserver != NULL){
 		pObserver->MQTTRecv();
 	}
 }
 
+/***
+ * Longest time the agent loop has been held by the router
+ * @return micro seconds
+ */
+uint32_t MQTTAgent::getRouteTimeMax(){
+	return xRouteTimeMax;
+}
+
+/***
+ * Average time the agent loop has been held by the router
+ * @return micro seconds
+ */
+uint32_t MQTTAgent::getRouteTimeAvg(){
+	if (xRouteCount == 0){
+		return 0;
+	}
+	return (uint32_t)(xRouteTimeTotal / xRouteCount);
+}
+
+/***
+ * Number of publishes queued to the agent
+ * @return
+ */
+uint32_t MQTTAgent::getPubCount(){
+	return xPubCount;
+}
+
+/***
+ * Bytes of packet header, including topic, put on the wire for all
+ * publishes. Payload bytes are not included
+ * @return
+ */
+uint32_t MQTTAgent::getPubHeaderBytes(){
+	return xPubHeaderBytes;
+}
+
+/***
+ * Bytes of payload put on the wire for all publishes
+ * @return
+ */
+uint32_t MQTTAgent::getPubPayloadBytes(){
+	return xPubPayloadBytes;
+}
+
+
+/***
+ * Route part of a streamed message to the router object
+ * @param topic - non zero terminated string
+ * @param topicLen - topic length
+ * @param phase - Start, Continue, End or Abort
+ * @param chunk - chunk of payload
+ * @param chunkLen - length of chunk
+ * @param offset - offset of chunk within payload
+ * @param totalLen - total payload length
+ */
+void MQTTAgent::routeStream(const char * topic, size_t topicLen,
+		MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+		size_t offset, size_t totalLen){
+	if (pRouter != NULL){
+		pRouter->routeStream(topic, topicLen, phase, chunk, chunkLen,
+				offset, totalLen, this);
+	}
+	if ((pObserver != NULL) && (phase == MQTTStreamEnd)){
+		pObserver->MQTTRecv();
+	}
+}
+
+/***
+ * Reset stream state at start of a connection
+ */
+void MQTTAgent::streamReset(){
+	xStreamHdrLen = 0;
+	xStreamHdrPos = 0;
+	xStreamPassLeft = 0;
+}
+
+/***
+ * Transport read used by coreMQTT when streaming is off
+ * @param pNetworkContext - Used to locate the MQTTAgent object
+ * @param pBuffer - Buffer to read into
+ * @param bytesToRecv - Maximum number of bytes to read
+ * @return number of bytes read, negative on error
+ */
+int32_t MQTTAgent::staticRead(NetworkContext_t * pNetworkContext,
+		void * pBuffer, size_t bytesToRecv){
+	MQTTAgent *a = (MQTTAgent *)pNetworkContext->mqttTask;
+	return a->netRead(pBuffer, bytesToRecv);
+}
+
+/***
+ * Transport send used by coreMQTT
+ * @param pNetworkContext - Used to locate the MQTTAgent object
+ * @param pBuffer - Buffer to send
+ * @param bytesToSend - number of bytes
+ * @return number of bytes sent, negative on error
+ */
+int32_t MQTTAgent::staticSend(NetworkContext_t * pNetworkContext,
+		const void * pBuffer, size_t bytesToSend){
+	MQTTAgent *a = (MQTTAgent *)pNetworkContext->mqttTask;
+	return a->netSend(pBuffer, bytesToSend);
+}
+
+/***
+ * Read from the transport. If TX ring is on the read must not wait on the
+ * network, so the transport lock is only held for a read that can't block
+ * and the TX task is never starved
+ * @param pBuffer - Buffer to read into
+ * @param bytesToRecv - Maximum number of bytes to read
+ * @return number of bytes read, negative on error
+ */
+int32_t MQTTAgent::netRead(void * pBuffer, size_t bytesToRecv){
+	int32_t res;
+
+	if (xTxRing){
+		if (xTxError){
+			return -1;
+		}
+		xSemaphoreTake(xTransLock, portMAX_DELAY);
+		res = pTrans->transReadNB(&xNetworkContext, pBuffer, bytesToRecv);
+		xSemaphoreGive(xTransLock);
+
+		//Mid packet coreMQTT retries at once, so let the TX task run
+		if ((res == 0) && (bytesToRecv > 1)){
+			vTaskDelay(1);
+		}
+	} else {
+		res = pTrans->transRead(&xNetworkContext, pBuffer, bytesToRecv);
+	}
+
+	if (res > 0){
+		xRxBytes += res;
+	}
+	return res;
+}
+
+/***
+ * Send to the transport, or queue on the TX ring if on
+ * @param pBuffer - Buffer to send
+ * @param bytesToSend - number of bytes
+ * @return number of bytes sent or queued, negative on error
+ */
+int32_t MQTTAgent::netSend(const void * pBuffer, size_t bytesToSend){
+	int32_t res;
+
+	if (xTxRing){
+		if (xTxError){
+			return -1;
+		}
+		//Partial send is fine, coreMQTT sends the rest
+		return xStreamBufferSend(xTxBuffer, pBuffer, bytesToSend,
+				pdMS_TO_TICKS(MQTT_AGENT_TX_TIMEOUT));
+	}
+
+	res = pTrans->transSend(&xNetworkContext, pBuffer, bytesToSend);
+	if (res > 0){
+		xTxBytes += res;
+	}
+	return res;
+}
+
+/***
+ * Close the transport, discarding anything left on the TX ring
+ */
+void MQTTAgent::netClose(){
+	if (xTxRing && (xTxHandle != NULL)){
+		xSemaphoreTake(xTransLock, portMAX_DELAY);
+		pTrans->transClose();
+		xTxFlush = true;
+		xSemaphoreGive(xTransLock);
+
+		//Wait for TX task to empty the ring
+		while (xTxFlush){
+			vTaskDelay(1);
+		}
+	} else {
+		pTrans->transClose();
+	}
+}
+
+/***
+ * Task that drains the TX ring to the transport
+ * @param pvParameters - MQTTAgent object
+ */
+void MQTTAgent::vTxTask( void * pvParameters ){
+	MQTTAgent *task = (MQTTAgent *) pvParameters;
+	task->txRun();
+}
+
+/***
+ * Run loop for the TX task
+ */
+void MQTTAgent::txRun(){
+	uint8_t chunk[MQTT_AGENT_TX_CHUNK];
+	size_t len;
+	size_t sent;
+	int32_t res;
+
+	for(;;){
+		len = xStreamBufferReceive(xTxBuffer, chunk, MQTT_AGENT_TX_CHUNK,
+				pdMS_TO_TICKS(MQTT_AGENT_TX_TIMEOUT));
+
+		//Connection closed so throw away anything queued for it
+		if (xTxFlush){
+			while (xStreamBufferReceive(xTxBuffer, chunk, MQTT_AGENT_TX_CHUNK, 0) > 0){
+				;
+			}
+			xTxError = false;
+			xTxFlush = false;
+			continue;
+		}
+
+		sent = 0;
+		while ((sent < len) && !xTxError){
+			xSemaphoreTake(xTransLock, portMAX_DELAY);
+			res = pTrans->transSend(&xNetworkContext, &chunk[sent], len - sent);
+			xSemaphoreGive(xTransLock);
+			if (res <= 0){
+				LogError(("TX ring send failed %d", res));
+				xTxError = true;
+			} else {
+				sent += res;
+				xTxBytes += res;
+			}
+		}
+	}
+}
+
+/***
+ * Transport read used by coreMQTT when streaming is on
+ * @param pNetworkContext - Used to locate the MQTTAgent object
+ * @param pBuffer - Buffer to read into
+ * @param bytesToRecv - Maximum number of bytes to read
+ * @return number of bytes read, negative on error
+ */
+int32_t MQTTAgent::streamRead(NetworkContext_t * pNetworkContext,
+		void * pBuffer, size_t bytesToRecv){
+	MQTTAgent *a = (MQTTAgent *)pNetworkContext->mqttTask;
+	return a->streamRecv(pBuffer, bytesToRecv);
+}
+
+/***
+ * Read for coreMQTT, checking the header of each packet. Oversized
+ * publish packets are consumed here and not seen by coreMQTT
+ * @param pBuffer - Buffer to read into
+ * @param bytesToRecv - Maximum number of bytes to read
+ * @return number of bytes read, negative on error
+ */
+int32_t MQTTAgent::streamRecv(void * pBuffer, size_t bytesToRecv){
+	int32_t res;
+	size_t len;
+
+	//Replay header bytes already read while checking the packet
+	if (xStreamHdrPos < xStreamHdrLen){
+		len = xStreamHdrLen - xStreamHdrPos;
+		if (len > bytesToRecv){
+			len = bytesToRecv;
+		}
+		memcpy(pBuffer, &xStreamHdr[xStreamHdrPos], len);
+		xStreamHdrPos += len;
+		return len;
+	}
+
+	//Rest of a packet that coreMQTT is reading
+	if (xStreamPassLeft > 0){
+		len = bytesToRecv;
+		if (len > xStreamPassLeft){
+			len = xStreamPassLeft;
+		}
+		res = netRead(pBuffer, len);
+		if (res > 0){
+			xStreamPassLeft -= res;
+		}
+		return res;
+	}
+
+	//At a packet boundary so read the fixed header
+	res = netRead(xStreamHdr, 1);
+	if (res <= 0){
+		return res;
+	}
+	xStreamHdrLen = 1;
+	xStreamHdrPos = 0;
+
+	size_t remLen = 0;
+	size_t mult = 1;
+	do {
+		if (xStreamHdrLen >= sizeof(xStreamHdr)){
+			LogError(("Malformed remaining length"));
+			return -1;
+		}
+		if (!streamReadExact(&xStreamHdr[xStreamHdrLen], 1)){
+			return -1;
+		}
+		remLen += (xStreamHdr[xStreamHdrLen] & 0x7F) * mult;
+		mult *= 128;
+		xStreamHdrLen++;
+	} while ((xStreamHdr[xStreamHdrLen - 1] & 0x80) != 0);
+
+	uint8_t qos = (xStreamHdr[0] >> 1) & 0x03;
+	if (((xStreamHdr[0] & 0xF0) == MQTT_PACKET_TYPE_PUBLISH) &&
+			(qos < 2) &&
+			((xStreamHdrLen + remLen) > MQTT_AGENT_RX_BUFFER_SIZE)){
+		streamReset();
+		if (!streamPublish(qos, remLen)){
+			return -1;
+		}
+		//Nothing for coreMQTT this time
+		return 0;
+	}
+
+	//Normal packet, coreMQTT reads the header then the body
+	xStreamPassLeft = remLen;
+	return streamRecv(pBuffer, bytesToRecv);
+}
+
+/***
+ * Read body of an oversized publish and deliver in chunks
+ * @param qos - QoS of the publish
+ * @param remLen - remaining length of the packet
+ * @return false if the connection failed
+ */
+bool MQTTAgent::streamPublish(uint8_t qos, size_t remLen){
+	uint8_t buf[4];
+	size_t topicLen;
+	size_t headLen;
+	size_t payloadLen;
+	size_t offset = 0;
+	size_t len;
+	uint16_t packetId = 0;
+	bool routed;
+
+	if (!streamReadExact(buf, 2)){
+		return false;
+	}
+	topicLen = (buf[0] << 8) | buf[1];
+	headLen = 2 + topicLen;
+	if (qos > 0){
+		headLen += 2;
+	}
+	if (headLen > remLen){
+		LogError(("Malformed publish"));
+		return false;
+	}
+	payloadLen = remLen - headLen;
+
+	routed = (topicLen <= MQTT_STREAM_TOPIC_LEN);
+	if (routed){
+		if (!streamReadExact(xStreamTopic, topicLen)){
+			return false;
+		}
+	} else {
+		LogWarn(("Streamed topic too long, discarding"));
+		if (!streamDiscard(topicLen)){
+			return false;
+		}
+	}
+
+	if (qos > 0){
+		if (!streamReadExact(buf, 2)){
+			return false;
+		}
+		packetId = (buf[0] << 8) | buf[1];
+	}
+
+	if (routed){
+		routeStream(xStreamTopic, topicLen, MQTTStreamStart,
+				NULL, 0, 0, payloadLen);
+	}
+
+	while (offset < payloadLen){
+		len = payloadLen - offset;
+		if (len > MQTT_STREAM_CHUNK_LEN){
+			len = MQTT_STREAM_CHUNK_LEN;
+		}
+		if (!streamReadExact(xStreamChunk, len)){
+			if (routed){
+				routeStream(xStreamTopic, topicLen, MQTTStreamAbort,
+						NULL, 0, offset, payloadLen);
+			}
+			return false;
+		}
+		if (routed){
+			routeStream(xStreamTopic, topicLen, MQTTStreamContinue,
+					xStreamChunk, len, offset, payloadLen);
+		}
+		offset += len;
+	}
+
+	if (routed){
+		routeStream(xStreamTopic, topicLen, MQTTStreamEnd,
+				NULL, 0, payloadLen, payloadLen);
+	}
+
+	//Acknowledge as coreMQTT never saw the packet
+	if (qos == 1){
+		buf[0] = 0x40;
+		buf[1] = 0x02;
+		buf[2] = packetId >> 8;
+		buf[3] = packetId & 0xFF;
+		if (!streamSendExact(buf, 4)){
+			LogError(("Failed to send PUBACK"));
+			return false;
+		}
+	}
+	return true;
+}
+
+/***
+ * Read exact number of bytes from transport, waiting up to
+ * MQTT_STREAM_TIMEOUT between bytes
+ * @param pBuffer - buffer to read into
+ * @param len - number of bytes
+ * @return false on error or timeout
+ */
+bool MQTTAgent::streamReadExact(void * pBuffer, size_t len){
+	uint8_t *p = (uint8_t *)pBuffer;
+	size_t got = 0;
+	uint32_t last = Transport::getCurrentTime();
+
+	while (got < len){
+		int32_t res = netRead(&p[got], len - got);
+		if (res < 0){
+			return false;
+		}
+		if (res == 0){
+			if ((Transport::getCurrentTime() - last) > MQTT_STREAM_TIMEOUT){
+				LogError(("Stream read timeout"));
+				return false;
+			}
+			vTaskDelay(1);
+		} else {
+			got += res;
+			last = Transport::getCurrentTime();
+		}
+	}
+	return true;
+}
+
+/***
+ * Send exact number of bytes to transport, as the TX ring may take
+ * only part of them. Waits up to MQTT_STREAM_TIMEOUT between bytes
+ * @param pBuffer - buffer to send from
+ * @param len - number of bytes
+ * @return false on error or timeout
+ */
+bool MQTTAgent::streamSendExact(const void * pBuffer, size_t len){
+	const uint8_t *p = (const uint8_t *)pBuffer;
+	size_t sent = 0;
+	uint32_t last = Transport::getCurrentTime();
+
+	while (sent < len){
+		int32_t res = netSend(&p[sent], len - sent);
+		if (res < 0){
+			return false;
+		}
+		if (res == 0){
+			if ((Transport::getCurrentTime() - last) > MQTT_STREAM_TIMEOUT){
+				LogError(("Stream send timeout"));
+				return false;
+			}
+			vTaskDelay(1);
+		} else {
+			sent += res;
+			last = Transport::getCurrentTime();
+		}
+	}
+	return true;
+}
+
+/***
+ * Read and discard bytes from transport
+ * @param len - number of bytes
+ * @return false on error or timeout
+ */
+bool MQTTAgent::streamDiscard(size_t len){
+	size_t chunk;
+
+	while (len > 0){
+		chunk = len;
+		if (chunk > MQTT_STREAM_CHUNK_LEN){
+			chunk = MQTT_STREAM_CHUNK_LEN;
+		}
+		if (!streamReadExact(xStreamChunk, chunk)){
+			return false;
+		}
+		len -= chunk;
+	}
+	return true;
+}
@@ -12,6 +12,8 @@
 
 #include "MQTTConfig.h"
 #include "FreeRTOS.h"
+#include "semphr.h"
+#include "stream_buffer.h"
 #include "core_mqtt.h"
 #include "core_mqtt_agent.h"
 #include "MQTTTopicHelper.h"
@@ -30,6 +32,39 @@ extern "C" {
 #define MQTT_AGENT_NETWORK_BUFFER_SIZE 512
 #endif
 
+//Receive buffer given to coreMQTT. Also used to build outgoing packet headers
+//so must hold the CONNECT packet
+#ifndef MQTT_AGENT_RX_BUFFER_SIZE
+#define MQTT_AGENT_RX_BUFFER_SIZE MQTT_AGENT_NETWORK_BUFFER_SIZE
+#endif
+
+//Transmit ring, written by the agent loop and drained by the TX task
+#ifndef MQTT_AGENT_TX_BUFFER_SIZE
+#define MQTT_AGENT_TX_BUFFER_SIZE 1024
+#endif
+
+#ifndef MQTT_AGENT_TX_CHUNK
+#define MQTT_AGENT_TX_CHUNK 256
+#endif
+
+#ifndef MQTT_AGENT_TX_STACK
+#define MQTT_AGENT_TX_STACK 2048
+#endif
+
+//Agent task stack in words
+#ifndef MQTT_AGENT_STACK
+#define MQTT_AGENT_STACK 2512
+#endif
+
+//Hold task stacks and TCBs in the object rather than the heap
+#ifndef MQTT_AGENT_STATIC_TASKS
+#define MQTT_AGENT_STATIC_TASKS 1
+#endif
+
+#ifndef MQTT_AGENT_TX_TIMEOUT
+#define MQTT_AGENT_TX_TIMEOUT 500 //ms
+#endif
+
 #ifndef MAXSUBS
 #define MAXSUBS 12
 #endif
@@ -42,6 +77,25 @@ extern "C" {
 #define MQTT_RECON_DELAY 10
 #endif
 
+//Streamed receive of publish messages too large for the network buffer
+#ifndef MQTT_STREAM_CHUNK_LEN
+#define MQTT_STREAM_CHUNK_LEN 128
+#endif
+
+#ifndef MQTT_STREAM_TOPIC_LEN
+#define MQTT_STREAM_TOPIC_LEN 80
+#endif
+
+#ifndef MQTT_STREAM_TIMEOUT
+#define MQTT_STREAM_TIMEOUT 5000 //ms
+#endif
+
+//Maximum QoS1/2 publishes awaiting acknowledgement. Must be below
+//MQTT_STATE_ARRAY_MAX_COUNT in coreMQTT
+#ifndef MQTT_AGENT_MAX_INFLIGHT
+#define MQTT_AGENT_MAX_INFLIGHT 5
+#endif
+
 
 // Enumerator used to control the state machine at centre of agent
 enum MQTTState {  Offline, TCPReq, TCPConned, MQTTReq, MQTTConned, MQTTRecon, Online};
@@ -75,6 +129,36 @@ public:
 	 */
 	void credentials(const char * user, const char * passwd, const char * id = NULL );
 
+	/***
+	 * Turn on streamed receive. Publish messages too large for the network
+	 * buffer are passed to the router in chunks through routeStream,
+	 * rather than being rejected. QoS 0 and 1 only.
+	 * Must be called before start
+	 * @param stream - true to turn on
+	 */
+	void setStreamRecv(bool stream);
+
+	/***
+	 * Turn on the transmit ring. Outgoing packets are copied to a ring
+	 * buffer and written to the transport by a separate task, so the agent
+	 * loop can carry on receiving and building the next packet.
+	 * Must be called before start
+	 * @param ring - true to turn on
+	 */
+	void setTxRing(bool ring);
+
+	/***
+	 * Total bytes written to the transport
+	 * @return
+	 */
+	uint32_t getTxBytes();
+
+	/***
+	 * Total bytes read from the transport
+	 * @return
+	 */
+	uint32_t getRxBytes();
+
 	/***
 	 * Connect to mqtt server - Actual connection is done in the state machine so task must be running
 	 * @param target - hostname or ip address, Not copied so pointer must remain valid
@@ -126,24 +210,43 @@ public:
 	 */
 	virtual unsigned int getStakHighWater();
 
+	// Zero terminated versions forward to the length carrying ones
+	using MQTTInterface::pubToTopic;
+	using MQTTInterface::subToTopic;
+
 	/***
 	 * Publish message to topic
-	 * @param topic - zero terminated string. Copied by function
+	 * @param topic - topic with explicit length. Copied by function
 	 * @param payload - payload as pointer to memory block
 	 * @param payloadLen - length of memory block
 	 * @param QoS - quality of service - 0, 1 or 2
 	 * @param retain - ask broker to retain message
 	 */
-	virtual bool pubToTopic(const char * topic,  const void * payload,
+	virtual bool pubToTopic(std::string_view topic,  const void * payload,
 			size_t payloadLen, const uint8_t QoS=0, bool retain = false);
 
+	/***
+	 * Publish message to topic with the payload written by a callback
+	 * directly into the publish buffer held until the agent sends it
+	 * @param topic - topic with explicit length. Copied by function
+	 * @param maxLen - most bytes the writer may produce
+	 * @param writer - called once, before return, to write the payload
+	 * @param ctx - passed to writer
+	 * @param QoS - quality of service - 0, 1 or 2
+	 * @param retain - ask broker to retain message
+	 * @return false if writer abandoned or publish failed
+	 */
+	virtual bool pubToTopicWriter(std::string_view topic, size_t maxLen,
+			MQTTPayloadWriter writer, void *ctx,
+			const uint8_t QoS=0, bool retain = false);
+
 	/***
 	 * Subscribe to a topic, mesg will be sent to router object
-	 * @param topic
+	 * @param topic - topic with explicit length. Not copied so must remain valid
 	 * @param QoS
 	 * @return
 	 */
-	virtual bool subToTopic(const char * topic, const uint8_t QoS=0);
+	virtual bool subToTopic(std::string_view topic, const uint8_t QoS=0);
 
 	/***
 	 * Get the router object handling all received messages
@@ -168,6 +271,51 @@ public:
 	 */
 	virtual void route(const char * topic, size_t topicLen, const void * payload, size_t payloadLen);
 
+	/***
+	 * Route part of a streamed message to the router object
+	 * @param topic - non zero terminated string
+	 * @param topicLen - topic length
+	 * @param phase - Start, Continue, End or Abort
+	 * @param chunk - chunk of payload
+	 * @param chunkLen - length of chunk
+	 * @param offset - offset of chunk within payload
+	 * @param totalLen - total payload length
+	 */
+	virtual void routeStream(const char * topic, size_t topicLen,
+			MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+			size_t offset, size_t totalLen);
+
+	/***
+	 * Longest time the agent loop has been held by the router
+	 * @return micro seconds
+	 */
+	uint32_t getRouteTimeMax();
+
+	/***
+	 * Average time the agent loop has been held by the router
+	 * @return micro seconds
+	 */
+	uint32_t getRouteTimeAvg();
+
+	/***
+	 * Number of publishes queued to the agent
+	 * @return
+	 */
+	uint32_t getPubCount();
+
+	/***
+	 * Bytes of packet header, including topic, put on the wire for all
+	 * publishes. Payload bytes are not included
+	 * @return
+	 */
+	uint32_t getPubHeaderBytes();
+
+	/***
+	 * Bytes of payload put on the wire for all publishes
+	 * @return
+	 */
+	uint32_t getPubPayloadBytes();
+
 private:
 	/***
 	 * Initialisation code
@@ -239,6 +387,115 @@ private:
 	 */
 	void setConnState(MQTTState s);
 
+	/***
+	 * Transport read used by coreMQTT when streaming is off
+	 * @param pNetworkContext - Used to locate the MQTTAgent object
+	 * @param pBuffer - Buffer to read into
+	 * @param bytesToRecv - Maximum number of bytes to read
+	 * @return number of bytes read, negative on error
+	 */
+	static int32_t staticRead(NetworkContext_t * pNetworkContext,
+			void * pBuffer, size_t bytesToRecv);
+
+	/***
+	 * Transport send used by coreMQTT
+	 * @param pNetworkContext - Used to locate the MQTTAgent object
+	 * @param pBuffer - Buffer to send
+	 * @param bytesToSend - number of bytes
+	 * @return number of bytes sent, negative on error
+	 */
+	static int32_t staticSend(NetworkContext_t * pNetworkContext,
+			const void * pBuffer, size_t bytesToSend);
+
+	/***
+	 * Read from the transport, holding the transport lock if TX ring is on
+	 * @param pBuffer - Buffer to read into
+	 * @param bytesToRecv - Maximum number of bytes to read
+	 * @return number of bytes read, negative on error
+	 */
+	int32_t netRead(void * pBuffer, size_t bytesToRecv);
+
+	/***
+	 * Send to the transport, or queue on the TX ring if on
+	 * @param pBuffer - Buffer to send
+	 * @param bytesToSend - number of bytes
+	 * @return number of bytes sent or queued, negative on error
+	 */
+	int32_t netSend(const void * pBuffer, size_t bytesToSend);
+
+	/***
+	 * Close the transport, discarding anything left on the TX ring
+	 */
+	void netClose();
+
+	/***
+	 * Task that drains the TX ring to the transport
+	 * @param pvParameters - MQTTAgent object
+	 */
+	static void vTxTask( void * pvParameters );
+
+	/***
+	 * Run loop for the TX task
+	 */
+	void txRun();
+
+	/***
+	 * Transport read used by coreMQTT when streaming is on
+	 * @param pNetworkContext - Used to locate the MQTTAgent object
+	 * @param pBuffer - Buffer to read into
+	 * @param bytesToRecv - Maximum number of bytes to read
+	 * @return number of bytes read, negative on error
+	 */
+	static int32_t streamRead(NetworkContext_t * pNetworkContext,
+			void * pBuffer, size_t bytesToRecv);
+
+	/***
+	 * Read for coreMQTT, checking the header of each packet. Oversized
+	 * publish packets are consumed here and not seen by coreMQTT
+	 * @param pBuffer - Buffer to read into
+	 * @param bytesToRecv - Maximum number of bytes to read
+	 * @return number of bytes read, negative on error
+	 */
+	int32_t streamRecv(void * pBuffer, size_t bytesToRecv);
+
+	/***
+	 * Read body of an oversized publish and deliver in chunks
+	 * @param qos - QoS of the publish
+	 * @param remLen - remaining length of the packet
+	 * @return false if the connection failed
+	 */
+	bool streamPublish(uint8_t qos, size_t remLen);
+
+	/***
+	 * Read exact number of bytes from transport, waiting up to
+	 * MQTT_STREAM_TIMEOUT between bytes
+	 * @param pBuffer - buffer to read into
+	 * @param len - number of bytes
+	 * @return false on error or timeout
+	 */
+	bool streamReadExact(void * pBuffer, size_t len);
+
+	/***
+	 * Send exact number of bytes to transport, waiting up to
+	 * MQTT_STREAM_TIMEOUT between bytes
+	 * @param pBuffer - buffer to send from
+	 * @param len - number of bytes
+	 * @return false on error or timeout
+	 */
+	bool streamSendExact(const void * pBuffer, size_t len);
+
+	/***
+	 * Read and discard bytes from transport
+	 * @param len - number of bytes
+	 * @return false on error or timeout
+	 */
+	bool streamDiscard(size_t len);
+
+	/***
+	 * Reset stream state at start of a connection
+	 */
+	void streamReset();
+
 
 	NetworkContext_t xNetworkContext;
 	TCPTransport xTcpTrans;
@@ -266,12 +523,16 @@ private:
 	MQTTRouter * pRouter = NULL;
 
 	// Buffers and queues
-	uint8_t xNetworkBuffer[ MQTT_AGENT_NETWORK_BUFFER_SIZE ];
+	uint8_t xNetworkBuffer[ MQTT_AGENT_RX_BUFFER_SIZE ];
 	uint8_t xStaticQueueStorageArea[ MQTT_AGENT_COMMAND_QUEUE_LENGTH * sizeof( MQTTAgentCommand_t * ) ];
 	StaticQueue_t xStaticQueueStructure;
 	MQTTAgentMessageContext_t xCommandQueue;
 	MQTTAgentContext_t xGlobalMqttAgentContext;
 	TaskHandle_t xHandle = NULL;
+#if MQTT_AGENT_STATIC_TASKS
+	StackType_t xStack[ MQTT_AGENT_STACK ];
+	StaticTask_t xTCB;
+#endif
 
 	//State machine state
 	MQTTState xConnState = Offline;
@@ -280,6 +541,48 @@ private:
 	//Single Observer
 	MQTTAgentObserver *pObserver = NULL;
 
+	//Streamed receive
+	bool xStreamRecv = false;
+	uint8_t xStreamHdr[5];
+	size_t xStreamHdrLen = 0;
+	size_t xStreamHdrPos = 0;
+	size_t xStreamPassLeft = 0;
+	char xStreamTopic[MQTT_STREAM_TOPIC_LEN];
+	uint8_t xStreamChunk[MQTT_STREAM_CHUNK_LEN];
+
+	//Transmit ring
+	bool xTxRing = false;
+	StreamBufferHandle_t xTxBuffer = NULL;
+	uint8_t xTxStorage[ MQTT_AGENT_TX_BUFFER_SIZE + 1 ];
+	StaticStreamBuffer_t xTxStruct;
+	SemaphoreHandle_t xTransLock = NULL;
+	StaticSemaphore_t xTransLockStruct;
+	TaskHandle_t xTxHandle = NULL;
+#if MQTT_AGENT_STATIC_TASKS
+	StackType_t xTxStack[ MQTT_AGENT_TX_STACK ];
+	StaticTask_t xTxTCB;
+#endif
+	volatile bool xTxError = false;
+	volatile bool xTxFlush = false;
+
+	//Throughput
+	volatile uint32_t xTxBytes = 0;
+	volatile uint32_t xRxBytes = 0;
+
+	//Time agent loop is stalled in the router, micro seconds
+	uint32_t xRouteTimeMax = 0;
+	uint64_t xRouteTimeTotal = 0;
+	uint32_t xRouteCount = 0;
+
+	//Window of publishes waiting for acknowledgement
+	SemaphoreHandle_t xInflight = NULL;
+	StaticSemaphore_t xInflightStruct;
+
+	//Wire usage of publishes
+	volatile uint32_t xPubCount = 0;
+	volatile uint32_t xPubHeaderBytes = 0;
+	volatile uint32_t xPubPayloadBytes = 0;
+
 };
 
 #endif /* MQTTAGENT_H_ */
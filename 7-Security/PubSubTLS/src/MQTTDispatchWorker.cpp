@@ -0,0 +1,84 @@
+/*
+ * MQTTDispatchWorker.cpp
+ *
+ * Worker task for the inbound dispatch stage. Takes messages copied out of
+ * the MQTT Agent loop and passes them on to the application router
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "MQTTDispatchWorker.h"
+
+/***
+ * Constructor
+ * @param freeQ - queue of free message slots, slot returned here once routed
+ * @param target - router that will handle the message
+ */
+MQTTDispatchWorker::MQTTDispatchWorker(QueueHandle_t freeQ, MQTTRouter *target) {
+	xFreeQ = freeQ;
+	pTarget = target;
+
+	xMsgQ = xQueueCreateStatic( MQTT_DISPATCH_QUEUE_LEN,
+								sizeof(MQTTDispatchMsg *),
+								xMsgQStorage,
+								&xMsgQStruct);
+	if (xMsgQ == NULL){
+		LogError(("Unable to create dispatch Queue\n"));
+	}
+}
+
+/***
+ * Destructor
+ */
+MQTTDispatchWorker::~MQTTDispatchWorker() {
+	// NOP
+}
+
+/***
+ * Set where messages go, for workers held in an array. Call before start
+ * @param freeQ - queue of free message slots, slot returned here once routed
+ * @param target - router that will handle the message
+ */
+void MQTTDispatchWorker::setTarget(QueueHandle_t freeQ, MQTTRouter *target){
+	xFreeQ = freeQ;
+	pTarget = target;
+}
+
+/***
+ * Post a message to the worker. Does not block
+ * @param msg - message slot, ownership passes to worker on success
+ * @return false if worker queue is full
+ */
+bool MQTTDispatchWorker::post(MQTTDispatchMsg *msg){
+	if (xMsgQ == NULL){
+		return false;
+	}
+	return (xQueueSendToBack(xMsgQ, &msg, 0) == pdTRUE);
+}
+
+/***
+ * Main Run Task for worker
+ * Messages for a given topic always come to the same worker, so handling
+ * them in queue order keeps per topic ordering
+ */
+void MQTTDispatchWorker::run(){
+	MQTTDispatchMsg *msg;
+
+	if (xMsgQ == NULL){
+		return;
+	}
+
+	while (true) {
+		if (xQueueReceive(xMsgQ, &msg, portMAX_DELAY) == pdTRUE){
+			if (pTarget != NULL){
+				pTarget->route(msg->topic,
+						msg->topicLen,
+						msg->payload,
+						msg->payloadLen,
+						msg->interface);
+			}
+			xQueueSendToBack(xFreeQ, &msg, 0);
+		}
+	}
+}
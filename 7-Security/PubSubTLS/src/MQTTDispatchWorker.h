@@ -0,0 +1,94 @@
+/*
+ * MQTTDispatchWorker.h
+ *
+ * Worker task for the inbound dispatch stage. Takes messages copied out of
+ * the MQTT Agent loop and passes them on to the application router
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _MQTTDISPATCHWORKER_H_
+#define _MQTTDISPATCHWORKER_H_
+
+#include "StaticAgent.h"
+#include "MQTTRouter.h"
+#include "MQTTInterface.h"
+#include "MQTTConfig.h"
+
+#include "queue.h"
+
+#ifndef MQTT_DISPATCH_TOPIC_LEN
+#define MQTT_DISPATCH_TOPIC_LEN 	80
+#endif
+
+#ifndef MQTT_DISPATCH_PAYLOAD_LEN
+#define MQTT_DISPATCH_PAYLOAD_LEN 	256
+#endif
+
+#ifndef MQTT_DISPATCH_QUEUE_LEN
+#define MQTT_DISPATCH_QUEUE_LEN 	8
+#endif
+
+#ifndef MQTT_DISPATCH_STACK
+#define MQTT_DISPATCH_STACK 		1024
+#endif
+
+// Inbound message copied out of the network buffer
+struct MQTTDispatchMsg {
+	char topic[MQTT_DISPATCH_TOPIC_LEN];
+	size_t topicLen;
+	uint8_t payload[MQTT_DISPATCH_PAYLOAD_LEN];
+	size_t payloadLen;
+	MQTTInterface *interface;
+};
+
+
+class MQTTDispatchWorker : public StaticAgent<MQTT_DISPATCH_STACK> {
+public:
+	/***
+	 * Constructor
+	 * @param freeQ - queue of free message slots, slot returned here once routed
+	 * @param target - router that will handle the message
+	 */
+	MQTTDispatchWorker(QueueHandle_t freeQ = NULL, MQTTRouter *target = NULL);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~MQTTDispatchWorker();
+
+	/***
+	 * Set where messages go, for workers held in an array. Call before start
+	 * @param freeQ - queue of free message slots, slot returned here once routed
+	 * @param target - router that will handle the message
+	 */
+	void setTarget(QueueHandle_t freeQ, MQTTRouter *target);
+
+	/***
+	 * Post a message to the worker. Does not block
+	 * @param msg - message slot, ownership passes to worker on success
+	 * @return false if worker queue is full
+	 */
+	bool post(MQTTDispatchMsg *msg);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+private:
+	//Router to pass messages too
+	MQTTRouter *pTarget = NULL;
+
+	//Queue slots are returned to
+	QueueHandle_t xFreeQ = NULL;
+
+	//Queue of messages waiting for this worker
+	QueueHandle_t xMsgQ = NULL;
+	uint8_t xMsgQStorage[ MQTT_DISPATCH_QUEUE_LEN * sizeof(MQTTDispatchMsg *) ];
+	StaticQueue_t xMsgQStruct;
+};
+
+#endif /* _MQTTDISPATCHWORKER_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "MQTTInterface.h"
+#include "FreeRTOS.h"
 
 MQTTInterface::MQTTInterface() {
 	// TODO Auto-generated constructor stub
@@ -16,3 +17,56 @@ MQTTInterface::~MQTTInterface() {
 	// TODO Auto-generated destructor stub
 }
 
+
+/***
+ * Publish message to topic
+ * Forwards to the length carrying version
+ * @param topic - zero terminated string. Copied by function
+ * @param payload - payload as pointer to memory block
+ * @param payloadLen - length of memory block
+ * @param QoS, QoS level of publish (0-2)
+ * @param retain - Ask broker to retain message
+ */
+bool MQTTInterface::pubToTopic(const char * topic, const void * payload,
+		size_t payloadLen, const uint8_t QoS, bool retain){
+	return pubToTopic(std::string_view(topic), payload, payloadLen, QoS, retain);
+}
+
+/***
+ * Subscribe to a topic, mesg will be sent to router object
+ * Forwards to the length carrying version
+ * @param topic - zero terminated string. Not copied so must remain valid
+ * @param QoS
+ * @return
+ */
+bool MQTTInterface::subToTopic(const char * topic, const uint8_t QoS){
+	return subToTopic(std::string_view(topic), QoS);
+}
+
+/***
+ * Publish message to topic with the payload written by a callback.
+ * Default writes to a temporary buffer and publishes that, implementations
+ * should override to write in place
+ * @param topic - topic with explicit length, need not be zero terminated.
+ * Copied by function
+ * @param maxLen - most bytes the writer may produce
+ * @param writer - called once, before return, to write the payload
+ * @param ctx - passed to writer
+ * @param QoS, QoS level of publish (0-2)
+ * @param retain - Ask broker to retain message
+ * @return false if writer abandoned or publish failed
+ */
+bool MQTTInterface::pubToTopicWriter(std::string_view topic, size_t maxLen,
+		MQTTPayloadWriter writer, void *ctx, const uint8_t QoS, bool retain){
+	bool res = false;
+	void *buf = pvPortMalloc(maxLen);
+	if (buf == NULL){
+		return false;
+	}
+	size_t len = writer(ctx, buf, maxLen);
+	if (len <= maxLen){
+		res = pubToTopic(topic, buf, len, QoS, retain);
+	}
+	vPortFree(buf);
+	return res;
+}
@@ -12,6 +12,20 @@
 
 #include <stdlib.h>
 #include <pico/stdlib.h>
+#include <string_view>
+
+//Returned by a payload writer to abandon the publish
+#define MQTT_WRITER_ABANDON 	((size_t)-1)
+
+/***
+ * Writes a publish payload in place
+ * @param ctx - context given with the publish
+ * @param buf - buffer to write the payload to
+ * @param len - size of buffer
+ * @return length of payload written, may be zero, or
+ * MQTT_WRITER_ABANDON to abandon the publish
+ */
+typedef size_t (*MQTTPayloadWriter)(void *ctx, void *buf, size_t len);
 
 class MQTTInterface {
 public:
@@ -26,15 +40,44 @@ public:
 
 	/***
 	 * Publish message to topic
+	 * Forwards to the length carrying version
 	 * @param topic - zero terminated string. Copied by function
 	 * @param payload - payload as pointer to memory block
 	 * @param payloadLen - length of memory block
 	 * @param QoS, QoS level of publish (0-2)
 	 * @param retain - Ask broker to retain message
 	 */
-	virtual bool pubToTopic(const char * topic, const void * payload,
+	bool pubToTopic(const char * topic, const void * payload,
+			size_t payloadLen, const uint8_t QoS=0, bool retain=false);
+
+	/***
+	 * Publish message to topic
+	 * @param topic - topic with explicit length, need not be zero terminated.
+	 * Copied by function
+	 * @param payload - payload as pointer to memory block
+	 * @param payloadLen - length of memory block
+	 * @param QoS, QoS level of publish (0-2)
+	 * @param retain - Ask broker to retain message
+	 */
+	virtual bool pubToTopic(std::string_view topic, const void * payload,
 			size_t payloadLen, const uint8_t QoS=0, bool retain=false)=0;
 
+	/***
+	 * Publish message to topic with the payload written by a callback
+	 * straight into the buffer that will be sent, so no scratch copy is needed
+	 * @param topic - topic with explicit length, need not be zero terminated.
+	 * Copied by function
+	 * @param maxLen - most bytes the writer may produce
+	 * @param writer - called once, before return, to write the payload
+	 * @param ctx - passed to writer
+	 * @param QoS, QoS level of publish (0-2)
+	 * @param retain - Ask broker to retain message
+	 * @return false if writer abandoned or publish failed
+	 */
+	virtual bool pubToTopicWriter(std::string_view topic, size_t maxLen,
+			MQTTPayloadWriter writer, void *ctx,
+			const uint8_t QoS=0, bool retain=false);
+
 	/***
 	 * Close connection
 	 */
@@ -42,11 +85,21 @@ public:
 
 	/***
 	 * Subscribe to a topic, mesg will be sent to router object
-	 * @param topic
+	 * Forwards to the length carrying version
+	 * @param topic - zero terminated string. Not copied so must remain valid
+	 * @param QoS
+	 * @return
+	 */
+	bool subToTopic(const char * topic, const uint8_t QoS=0);
+
+	/***
+	 * Subscribe to a topic, mesg will be sent to router object
+	 * @param topic - topic with explicit length, need not be zero terminated.
+	 * Not copied so must remain valid
 	 * @param QoS
 	 * @return
 	 */
-	virtual bool subToTopic(const char * topic, const uint8_t QoS=0)=0;
+	virtual bool subToTopic(std::string_view topic, const uint8_t QoS=0)=0;
 
 
 };
@@ -6,6 +6,7 @@
  */
 
 #include "MQTTRouter.h"
+#include "MQTTConfig.h"
 
 MQTTRouter::MQTTRouter() {
 	// NOP
@@ -17,3 +18,23 @@ MQTTRouter::~MQTTRouter() {
 }
 
 
+/***
+ * Route part of a message too large for the network buffer.
+ * Default implementation ignores the message.
+ * @param topic - non zero terminated string
+ * @param topicLen - length of topic
+ * @param phase - Start, Continue, End or Abort
+ * @param chunk - chunk of payload, NULL unless phase is Continue
+ * @param chunkLen - length of chunk
+ * @param offset - offset of chunk within the payload
+ * @param totalLen - total length of the payload
+ * @param interface - MQTT interface to use for any response publication
+ */
+void MQTTRouter::routeStream(const char *topic, size_t topicLen,
+		MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+		size_t offset, size_t totalLen, MQTTInterface *interface){
+	if (phase == MQTTStreamStart){
+		LogWarn(("Streamed msg of %u bytes ignored on %.*s\n",
+				totalLen, topicLen, topic));
+	}
+}
@@ -14,6 +14,9 @@
 
 #include "MQTTInterface.h"
 
+// Phase of a streamed inbound payload
+enum MQTTStreamPhase { MQTTStreamStart, MQTTStreamContinue, MQTTStreamEnd, MQTTStreamAbort };
+
 class MQTTRouter {
 public:
 	MQTTRouter();
@@ -36,6 +39,24 @@ public:
 	  */
 	 virtual void route(const char *topic, size_t topicLen, const void * payload, size_t payloadLen, MQTTInterface *interface)=0;
 
+	 /***
+	  * Route part of a message too large for the network buffer.
+	  * Called with Start, then Continue for each chunk, then End. Abort is
+	  * sent instead of End if the connection fails part way.
+	  * Default implementation ignores the message.
+	  * @param topic - non zero terminated string
+	  * @param topicLen - length of topic
+	  * @param phase - Start, Continue, End or Abort
+	  * @param chunk - chunk of payload, NULL unless phase is Continue
+	  * @param chunkLen - length of chunk
+	  * @param offset - offset of chunk within the payload
+	  * @param totalLen - total length of the payload
+	  * @param interface - MQTT interface to use for any response publication
+	  */
+	 virtual void routeStream(const char *topic, size_t topicLen,
+			 MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+			 size_t offset, size_t totalLen, MQTTInterface *interface);
+
 
 };
 
@@ -0,0 +1,174 @@
+/*
+ * MQTTRouterDispatch.cpp
+ *
+ * Optional inbound dispatch stage. Sits between the MQTT Agent and the
+ * application router. Messages are copied into a pool of fixed slots and
+ * handed to worker tasks, so slow handlers do not stall the agent loop.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "MQTTRouterDispatch.h"
+#include <string.h>
+#include <stdio.h>
+
+/***
+ * Constructor
+ * @param target - application router that will handle the messages
+ * @param workers - number of worker tasks (1 to MQTT_DISPATCH_MAX_WORKERS)
+ */
+MQTTRouterDispatch::MQTTRouterDispatch(MQTTRouter *target, uint8_t workers) {
+	pTarget = target;
+
+	xNumWorkers = workers;
+	if (xNumWorkers == 0){
+		xNumWorkers = 1;
+	}
+	if (xNumWorkers > MQTT_DISPATCH_MAX_WORKERS){
+		xNumWorkers = MQTT_DISPATCH_MAX_WORKERS;
+	}
+
+	//Populate the free slot pool
+	xFreeQ = xQueueCreateStatic( MQTT_DISPATCH_SLOTS,
+								 sizeof(MQTTDispatchMsg *),
+								 xFreeQStorage,
+								 &xFreeQStruct);
+	if (xFreeQ == NULL){
+		LogError(("Unable to create dispatch pool\n"));
+	} else {
+		for (uint8_t i=0; i < MQTT_DISPATCH_SLOTS; i++){
+			MQTTDispatchMsg *msg = &xSlots[i];
+			xQueueSendToBack(xFreeQ, &msg, 0);
+		}
+	}
+
+	for (uint8_t i=0; i < xNumWorkers; i++){
+		xWorkers[i].setTarget(xFreeQ, pTarget);
+	}
+}
+
+/***
+ * Destructor
+ */
+MQTTRouterDispatch::~MQTTRouterDispatch() {
+	// NOP
+}
+
+/***
+ * Start the worker tasks
+ * @param priority - priority for the workers
+ * @return true if all started
+ */
+bool MQTTRouterDispatch::start(UBaseType_t priority){
+	char name[MAX_NAME_LEN];
+	bool res = true;
+
+	for (uint8_t i=0; i < xNumWorkers; i++){
+		sprintf(name, "MQTTDispatch%d", i);
+		if (!xWorkers[i].start(name, priority)){
+			LogError(("Failed to start dispatch worker %d\n", i));
+			res = false;
+		}
+	}
+	return res;
+}
+
+/***
+ * Use interface to set subscriptions for the router
+ * Passed through to the target router
+ * @param interface
+ */
+void MQTTRouterDispatch::subscribe(MQTTInterface *interface){
+	if (pTarget != NULL){
+		pTarget->subscribe(interface);
+	}
+}
+
+/***
+ * Copy the message into a slot and queue it to a worker.
+ * Same topic always goes to the same worker to preserve ordering.
+ * Message is dropped if no slot is free or it is too large.
+ * @param topic - non zero terminated string
+ * @param topicLen - length of topic
+ * @param payload - memory structure of payload
+ * @param payloadLen - payload length
+ * @param interface - MQTT interface to use for any response publication
+ */
+void MQTTRouterDispatch::route(const char *topic, size_t topicLen,
+		const void * payload, size_t payloadLen, MQTTInterface *interface){
+	MQTTDispatchMsg *msg;
+
+	if ((topicLen > MQTT_DISPATCH_TOPIC_LEN) ||
+			(payloadLen > MQTT_DISPATCH_PAYLOAD_LEN)){
+		xDropped++;
+		LogWarn(("Dispatch msg too large, dropped %.*s\n", topicLen, topic));
+		return;
+	}
+
+	if (xQueueReceive(xFreeQ, &msg, 0) != pdTRUE){
+		xDropped++;
+		LogWarn(("Dispatch pool empty, dropped %.*s\n", topicLen, topic));
+		return;
+	}
+
+	memcpy(msg->topic, topic, topicLen);
+	msg->topicLen = topicLen;
+	memcpy(msg->payload, payload, payloadLen);
+	msg->payloadLen = payloadLen;
+	msg->interface = interface;
+
+	if (!xWorkers[workerFor(topic, topicLen)].post(msg)){
+		xQueueSendToBack(xFreeQ, &msg, 0);
+		xDropped++;
+		LogWarn(("Dispatch worker full, dropped %.*s\n", topicLen, topic));
+	}
+}
+
+/***
+ * Streamed messages are too large for a slot so are passed straight
+ * through to the target router within the agent loop
+ * @param topic - non zero terminated string
+ * @param topicLen - length of topic
+ * @param phase - Start, Continue, End or Abort
+ * @param chunk - chunk of payload, NULL unless phase is Continue
+ * @param chunkLen - length of chunk
+ * @param offset - offset of chunk within the payload
+ * @param totalLen - total length of the payload
+ * @param interface - MQTT interface to use for any response publication
+ */
+void MQTTRouterDispatch::routeStream(const char *topic, size_t topicLen,
+		MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+		size_t offset, size_t totalLen, MQTTInterface *interface){
+	if (pTarget != NULL){
+		pTarget->routeStream(topic, topicLen, phase, chunk, chunkLen,
+				offset, totalLen, interface);
+	}
+}
+
+/***
+ * Number of messages dropped due to overflow
+ * @return
+ */
+uint32_t MQTTRouterDispatch::getDropped(){
+	return xDropped;
+}
+
+/***
+ * Select worker for the topic using FNV-1a hash of the topic
+ * @param topic
+ * @param topicLen
+ * @return index of worker
+ */
+uint8_t MQTTRouterDispatch::workerFor(const char *topic, size_t topicLen){
+	uint32_t hash = 2166136261U;
+
+	if (xNumWorkers == 1){
+		return 0;
+	}
+	for (size_t i=0; i < topicLen; i++){
+		hash ^= (uint8_t)topic[i];
+		hash *= 16777619U;
+	}
+	return hash % xNumWorkers;
+}
@@ -0,0 +1,117 @@
+/*
+ * MQTTRouterDispatch.h
+ *
+ * Optional inbound dispatch stage. Sits between the MQTT Agent and the
+ * application router. Messages are copied into a pool of fixed slots and
+ * handed to worker tasks, so slow handlers do not stall the agent loop.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _MQTTROUTERDISPATCH_H_
+#define _MQTTROUTERDISPATCH_H_
+
+#include "MQTTRouter.h"
+#include "MQTTDispatchWorker.h"
+
+#ifndef MQTT_DISPATCH_SLOTS
+#define MQTT_DISPATCH_SLOTS 		8
+#endif
+
+//Workers are held in the object with their stacks, so every one up to
+//this costs RAM even if not started
+#ifndef MQTT_DISPATCH_MAX_WORKERS
+#define MQTT_DISPATCH_MAX_WORKERS 	2
+#endif
+
+class MQTTRouterDispatch : public MQTTRouter {
+public:
+	/***
+	 * Constructor
+	 * @param target - application router that will handle the messages
+	 * @param workers - number of worker tasks (1 to MQTT_DISPATCH_MAX_WORKERS)
+	 */
+	MQTTRouterDispatch(MQTTRouter *target, uint8_t workers = 1);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~MQTTRouterDispatch();
+
+	/***
+	 * Start the worker tasks
+	 * @param priority - priority for the workers
+	 * @return true if all started
+	 */
+	bool start(UBaseType_t priority = tskIDLE_PRIORITY);
+
+	/***
+	 * Use interface to set subscriptions for the router
+	 * Passed through to the target router
+	 * @param interface
+	 */
+	virtual void subscribe(MQTTInterface *interface);
+
+	/***
+	 * Copy the message into a slot and queue it to a worker.
+	 * Same topic always goes to the same worker to preserve ordering.
+	 * Message is dropped if no slot is free or it is too large.
+	 * @param topic - non zero terminated string
+	 * @param topicLen - length of topic
+	 * @param payload - memory structure of payload
+	 * @param payloadLen - payload length
+	 * @param interface - MQTT interface to use for any response publication
+	 */
+	virtual void route(const char *topic, size_t topicLen, const void * payload,
+			size_t payloadLen, MQTTInterface *interface);
+
+	/***
+	 * Streamed messages are too large for a slot so are passed straight
+	 * through to the target router within the agent loop
+	 * @param topic - non zero terminated string
+	 * @param topicLen - length of topic
+	 * @param phase - Start, Continue, End or Abort
+	 * @param chunk - chunk of payload, NULL unless phase is Continue
+	 * @param chunkLen - length of chunk
+	 * @param offset - offset of chunk within the payload
+	 * @param totalLen - total length of the payload
+	 * @param interface - MQTT interface to use for any response publication
+	 */
+	virtual void routeStream(const char *topic, size_t topicLen,
+			MQTTStreamPhase phase, const void * chunk, size_t chunkLen,
+			size_t offset, size_t totalLen, MQTTInterface *interface);
+
+	/***
+	 * Number of messages dropped due to overflow
+	 * @return
+	 */
+	uint32_t getDropped();
+
+private:
+	/***
+	 * Select worker for the topic
+	 * @param topic
+	 * @param topicLen
+	 * @return index of worker
+	 */
+	uint8_t workerFor(const char *topic, size_t topicLen);
+
+	//Application router
+	MQTTRouter *pTarget = NULL;
+
+	//Workers
+	MQTTDispatchWorker xWorkers[MQTT_DISPATCH_MAX_WORKERS];
+	uint8_t xNumWorkers = 0;
+
+	//Message slot pool
+	MQTTDispatchMsg xSlots[MQTT_DISPATCH_SLOTS];
+	QueueHandle_t xFreeQ = NULL;
+	uint8_t xFreeQStorage[ MQTT_DISPATCH_SLOTS * sizeof(MQTTDispatchMsg *) ];
+	StaticQueue_t xFreeQStruct;
+
+	//Overflow counter
+	volatile uint32_t xDropped = 0;
+};
+
+#endif /* _MQTTROUTERDISPATCH_H_ */
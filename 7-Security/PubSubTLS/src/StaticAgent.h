@@ -0,0 +1,58 @@
+/*
+ * StaticAgent.h
+ *
+ * Agent whose task stack and TCB are part of the object, sized at
+ * compile time. The task is created with xTaskCreateStatic so nothing
+ * is taken from the FreeRTOS heap when it starts or returned when it
+ * is deleted. Declare the object static or global so the stack is
+ * placed in .bss rather than on the creating task's stack.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _STATICAGENT_H_
+#define _STATICAGENT_H_
+
+#include "Agent.h"
+
+//Set to 0 to take every task from the FreeRTOS heap instead, for comparison
+#ifndef MQTT_AGENT_STATIC_TASKS
+#define MQTT_AGENT_STATIC_TASKS 1
+#endif
+
+template<configSTACK_DEPTH_TYPE STACK>
+class StaticAgent : public Agent {
+protected:
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize() {
+		return STACK;
+	}
+
+#if MQTT_AGENT_STATIC_TASKS
+	/***
+	 * Stack for the task
+	 * @return
+	 */
+	virtual StackType_t *getStaticStack() {
+		return xStack;
+	}
+
+	/***
+	 * TCB for the task
+	 * @return
+	 */
+	virtual StaticTask_t *getStaticTCB() {
+		return &xTCB;
+	}
+
+private:
+	StackType_t xStack[ STACK ];
+	StaticTask_t xTCB;
+#endif
+};
+
+#endif /* _STATICAGENT_H_ */
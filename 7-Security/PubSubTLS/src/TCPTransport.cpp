@@ -84,6 +84,25 @@ int32_t TCPTransport::transRead(NetworkContext_t * pNetworkContext, void * pBuff
 }
 
 
+/***
+ * Read only what can be read without waiting on the network
+ * @param pNetworkContext
+ * @param pBuffer
+ * @param bytesToRecv
+ * @return number of bytes read, 0 if none ready, negative on error
+ */
+int32_t TCPTransport::transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv){
+	int32_t dataIn = recv(xSock, (uint8_t *)pBuffer, bytesToRecv, MSG_DONTWAIT);
+
+	if (dataIn < 0){
+		if ((errno == 0) || (errno == EWOULDBLOCK) || (errno == EAGAIN)){
+			dataIn = 0;
+		}
+	}
+	return dataIn;
+}
+
+
 /***
  * Connect to remote TCP Socket
  * @param host - Host address
@@ -80,6 +80,15 @@ public:
 	 */
 	int32_t transRead(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv);
 
+	/***
+	 * Read only what can be read without waiting on the network
+	 * @param pNetworkContext
+	 * @param pBuffer
+	 * @param bytesToRecv
+	 * @return number of bytes read, 0 if none ready, negative on error
+	 */
+	int32_t transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv);
+
 
 	/***
 	 * returns current time, as time in ms since boot
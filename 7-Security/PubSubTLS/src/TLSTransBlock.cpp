@@ -78,6 +78,31 @@ int32_t TLSTransBlock::transRead(NetworkContext_t * pNetworkContext, void * pBuf
 	return dataIn;
 }
 
+/***
+ * Read only what can be read without waiting on the network.
+ * The socket read under wolfSSL is made with MSG_DONTWAIT, so a partial
+ * TLS record is kept by wolfSSL until the rest arrives
+ * @param pNetworkContext
+ * @param pBuffer
+ * @param bytesToRecv
+ * @return number of bytes read, 0 if none ready, negative on error
+ */
+int32_t TLSTransBlock::transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv){
+	int32_t dataIn;
+
+	xNonBlock = true;
+	dataIn = wolfSSL_read(pSSL, (uint8_t *)pBuffer, bytesToRecv);
+	xNonBlock = false;
+
+	if (dataIn <= 0){
+		int err = wolfSSL_get_error(pSSL, dataIn);
+		if (err == WOLFSSL_ERROR_WANT_READ){
+			dataIn = 0;
+		}
+	}
+	return dataIn;
+}
+
 
 
 
@@ -151,6 +176,9 @@ bool TLSTransBlock::transConnect(){
 		return false;
 	}
 
+	//Read through this object so IORecv can see xNonBlock
+	wolfSSL_SetIOReadCtx(pSSL, this);
+
 
 
 	ret = wolfSSL_connect(pSSL);
@@ -270,15 +298,18 @@ int TLSTransBlock::IOSend(WOLFSSL* ssl, char* buff, int sz, void* ctx){
 }
 
 int TLSTransBlock::IORecv(WOLFSSL* ssl, char* buff, int sz, void* ctx){
-    /* By default, ctx will be a pointer to the file descriptor to read from.
-     * This can be changed by calling wolfSSL_SetIOReadCtx(). */
-    int sockfd = *(int*)ctx;
+    /* ctx is set to the TLSTransBlock by wolfSSL_SetIOReadCtx() */
+    TLSTransBlock *self = (TLSTransBlock *)ctx;
+    int sockfd = self->xSock;
     int recvd;
 
 
     /* Receive message from socket */
-    if ((recvd = recv(sockfd, buff, sz, 0)) == -1) {
+    if ((recvd = recv(sockfd, buff, sz, self->xNonBlock ? MSG_DONTWAIT : 0)) == -1) {
         /* error encountered. Be responsible and report it in wolfSSL terms */
+        if (self->xNonBlock && ((errno == EWOULDBLOCK) || (errno == EAGAIN))){
+        	return WOLFSSL_CBIO_ERR_WANT_READ;
+        }
 
         int err = wolfSSL_get_error(ssl, errno);
         LogError(("IO RECEIVE ERROR: errno=%d sslErr=%d", errno, err));
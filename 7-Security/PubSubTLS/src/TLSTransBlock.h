@@ -1,7 +1,8 @@
 /*
  * TLSTransBlock.h
  *
- * TLS Transport - Blocking socket except for transRead of 1 byte which will not block
+ * TLS Transport - Blocking socket except for transRead of 1 byte and
+ * transReadNB which will not block
  * Written for the FreeRTOS coreMQTT transport requirements
  *
  * Does not set a certificate or enforce any certificate checks of the server
@@ -79,6 +80,15 @@ public:
 	 */
 	int32_t transRead(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv);
 
+	/***
+	 * Read only what can be read without waiting on the network
+	 * @param pNetworkContext
+	 * @param pBuffer
+	 * @param bytesToRecv
+	 * @return number of bytes read, 0 if none ready, negative on error
+	 */
+	int32_t transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv);
+
 private:
 
 	/***
@@ -143,6 +153,9 @@ private:
 
 	WOLFSSL_CTX* pCtx;
 	WOLFSSL* pSSL;
+
+	//IORecv must not wait on the socket
+	bool xNonBlock = false;
 };
 
 
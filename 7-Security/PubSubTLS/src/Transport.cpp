@@ -21,6 +21,19 @@ Transport::~Transport() {
 
 
 
+/***
+ * Read only what can be read without waiting on the network
+ * Transports that can not do this fall back to transRead
+ * @param pNetworkContext
+ * @param pBuffer
+ * @param bytesToRecv
+ * @return number of bytes read, 0 if none ready, negative on error
+ */
+int32_t Transport::transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv){
+	return transRead(pNetworkContext, pBuffer, bytesToRecv);
+}
+
+
 /***
  * Required by CoreMQTT returns time in ms
  * @return
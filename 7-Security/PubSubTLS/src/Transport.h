@@ -67,6 +67,16 @@ public:
 	 */
 	virtual int32_t transRead(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv) = 0;
 
+	/***
+	 * Read only what can be read without waiting on the network
+	 * Transports that can not do this fall back to transRead
+	 * @param pNetworkContext
+	 * @param pBuffer
+	 * @param bytesToRecv
+	 * @return number of bytes read, 0 if none ready, negative on error
+	 */
+	virtual int32_t transReadNB(NetworkContext_t * pNetworkContext, void * pBuffer, size_t bytesToRecv);
+
 
 	/***
 	 * returns current time, as time in ms since boot
@@ -24,6 +24,7 @@
 #include "MQTTAgentObserver.h"
 #include "LEDAgent.h"
 #include "MQTTRouterLED.h"
+#include "MQTTRouterDispatch.h"
 #include "TLSTransBlock.h"
 
 
@@ -56,6 +57,12 @@
 
 
 #define TASK_PRIORITY			( tskIDLE_PRIORITY + 1UL )
+#define MAIN_TASK_STACK			2048
+
+// Inbound dispatch workers, 0 to route within the MQTT Agent loop
+#ifndef MQTT_DISPATCH_WORKERS
+#define MQTT_DISPATCH_WORKERS	1
+#endif
 
 
 void runTimeStats(   ){
@@ -152,12 +159,15 @@ void main_task(void *params){
 	char mqttUser[] = MQTT_USER;
 	char mqttPwd[] = MQTT_PASSWD;
 
-	MQTTAgent mqttAgent;
+	//Static so the agents' task stacks are in .bss, not on this task's stack
+	static MQTTAgent mqttAgent;
 	MQTTAgentObserver mqttObs;
 	TLSTransBlock transport;
 
 	mqttAgent.setObserver(&mqttObs);
 	mqttAgent.setTransport(&transport);
+	mqttAgent.setStreamRecv(true);
+	mqttAgent.setTxRing(true);
 	mqttAgent.credentials(mqttUser, mqttPwd, mqttClient);
 
 	printf("Connecting to: %s(%d)\n", mqttTarget, mqttPort);
@@ -168,12 +178,36 @@ void main_task(void *params){
 	mqttAgent.start(TASK_PRIORITY);
 
 
-	LEDAgent ledAgent(LED_PAD, SWITCH_PAD, &mqttAgent);
+	static LEDAgent ledAgent(LED_PAD, SWITCH_PAD, &mqttAgent);
 	ledAgent.start("LEDAgent", TASK_PRIORITY);
 
 	MQTTRouterLED router(&ledAgent);
+#if MQTT_DISPATCH_WORKERS > 0
+	static MQTTRouterDispatch dispatch(&router, MQTT_DISPATCH_WORKERS);
+	dispatch.start(TASK_PRIORITY);
+	mqttAgent.setRouter(&dispatch);
+#else
 	mqttAgent.setRouter(&router);
+#endif
 
+	//With MQTT_AGENT_STATIC_TASKS=0 every task comes from the heap, so
+	//compare heap plus static agent RAM between the two builds
+	size_t staticRam = sizeof(mqttAgent) + sizeof(ledAgent);
+#if MQTT_DISPATCH_WORKERS > 0
+	staticRam += sizeof(dispatch);
+#endif
+#if MQTT_AGENT_STATIC_TASKS
+	staticRam += MAIN_TASK_STACK * sizeof(StackType_t) + sizeof(StaticTask_t);
+#endif
+	printf("Boot heap used %lu of %lu bytes, static agents %lu bytes\n",
+			(unsigned long)(configTOTAL_HEAP_SIZE - xPortGetFreeHeapSize()),
+			(unsigned long)configTOTAL_HEAP_SIZE,
+			(unsigned long)staticRam);
+
+	uint32_t routeMax = 0;
+	uint32_t txBytes = 0;
+	uint32_t rxBytes = 0;
+	uint32_t pubCount = 0;
 
     while(true) {
 
@@ -181,6 +215,32 @@ void main_task(void *params){
 
         vTaskDelay(3000);
 
+        //Report how long the agent loop has been held by routing
+        if (mqttAgent.getRouteTimeMax() != routeMax){
+        	routeMax = mqttAgent.getRouteTimeMax();
+        	printf("MQTT route stall max %lu us, avg %lu us\n",
+        			(unsigned long)routeMax,
+        			(unsigned long)mqttAgent.getRouteTimeAvg());
+        }
+
+        //Report transport throughput over the last period
+        if ((mqttAgent.getTxBytes() != txBytes) ||
+        		(mqttAgent.getRxBytes() != rxBytes)){
+        	printf("MQTT tx %lu B/s, rx %lu B/s\n",
+        			(unsigned long)((mqttAgent.getTxBytes() - txBytes) / 3),
+        			(unsigned long)((mqttAgent.getRxBytes() - rxBytes) / 3));
+        	txBytes = mqttAgent.getTxBytes();
+        	rxBytes = mqttAgent.getRxBytes();
+        }
+
+        //Report publish header overhead against payload
+        if (mqttAgent.getPubCount() != pubCount){
+        	pubCount = mqttAgent.getPubCount();
+        	printf("MQTT pub %lu msgs, header %lu B/msg, payload %lu B/msg\n",
+        			(unsigned long)pubCount,
+        			(unsigned long)(mqttAgent.getPubHeaderBytes() / pubCount),
+        			(unsigned long)(mqttAgent.getPubPayloadBytes() / pubCount));
+        }
 
         if (!WifiHelper::isJoined()){
         	printf("AP Link is down\n");
@@ -203,9 +263,16 @@ void main_task(void *params){
 
 
 void vLaunch( void) {
-    TaskHandle_t task;
+#if MQTT_AGENT_STATIC_TASKS
+    static StackType_t xMainStack[ MAIN_TASK_STACK ];
+    static StaticTask_t xMainTCB;
 
-    xTaskCreate(main_task, "MainThread", 2048, NULL, TASK_PRIORITY, &task);
+    xTaskCreateStatic(main_task, "MainThread", MAIN_TASK_STACK, NULL, TASK_PRIORITY,
+    		xMainStack, &xMainTCB);
+#else
+    TaskHandle_t task;
+    xTaskCreate(main_task, "MainThread", MAIN_TASK_STACK, NULL, TASK_PRIORITY, &task);
+#endif
 
     /* Start the tasks and timer running. */
     vTaskStartScheduler();
@@ -0,0 +1,102 @@
+# IoT Device batched scene change
+# Jon Durrant - 19-Oct-2026
+#
+# Send an array of commands as a single message, either
+# [{'on': True}, {'on': False}, ...] to TNG/<<device>>/TPC/LED/req
+# or [{'state': {'on': True}}, ...] to TNG/<<device>>/STATE/SET
+# Reports the messages received in reply and the time to the first state update
+# Takes <<device>> as first parameter on command line
+# Takes LED or SET as second parameter
+# Experts following env variables to be set
+# MQTT_CLIENT
+# MQTT_USER
+# MQTT_PASSWD
+# MQTT_HOST
+# MQTT_PORT
+
+import paho.mqtt.client as mqtt
+import json
+import time
+import sys
+import os
+
+#Check we have a target as a parameter on command line
+if (len(sys.argv) != 3):
+    print("Require target ID and LED or SET as parameters")
+    sys.exit()
+targetId = sys.argv[1]
+useSet = (sys.argv[2].upper() == "SET")
+
+# Grab environment variables
+clientId=os.environ.get("MQTT_CLIENT")
+user=os.environ.get("MQTT_USER")
+passwd=os.environ.get("MQTT_PASSWD")
+host= os.environ.get("MQTT_HOST")
+port=int(os.environ.get("MQTT_PORT"))
+print("MQTT %s:%d"%(host,port))
+
+#Set up topic name
+subTopic = "TNG/" + targetId + "/#"
+ledTopic = "TNG/" + targetId + "/TPC/LED/req"
+setTopic = "TNG/" + targetId + "/STATE/SET"
+
+sent = 0
+first = 0
+replies = 0
+
+# The callback for when the client receives a CONNACK response from the broker.
+def on_connect(client, userdata, flags, rc):
+    print("Connected with result code "+str(rc))
+
+
+# The callback for when a PUBLISH message is received from the server.
+def on_message(client, userdata, msg):
+    global first, replies
+    if (sent == 0):
+        return
+    replies = replies + 1
+    if (first == 0):
+        first = time.time()
+    print("Rcv topic=" +msg.topic+" msg="+str(msg.payload))
+
+# Connect to the broker
+client = mqtt.Client(client_id=clientId)
+client.username_pw_set(username=user, password=passwd)
+client.on_connect = on_connect
+client.on_message = on_message
+client.connect(host, port, 60)
+
+#Maintain connection loop in thread
+client.loop_start()
+
+#Subscribe to the Topic so we can see what was sent
+client.subscribe( subTopic )
+time.sleep(2)
+
+#Scene of several changes, only the last should be applied
+seq = int(time.time())
+if (useSet):
+    topic = setTopic
+    j = [
+        {'state': {'on': True}, 'seq': seq, 'src': 'batch'},
+        {'state': {'on': False}, 'seq': seq + 1, 'src': 'batch'},
+        {'state': {'on': True}, 'seq': seq + 2, 'src': 'batch'}
+        ]
+else:
+    topic = ledTopic
+    j = [
+        {'on': True, 'seq': seq, 'src': 'batch'},
+        {'on': False, 'seq': seq + 1, 'src': 'batch'},
+        {'on': True, 'seq': seq + 2, 'src': 'batch'}
+        ]
+p = json.dumps(j)
+print("Publishing batch %s to %s"%(p, topic))
+sent = time.time()
+infot = client.publish(topic, p, retain=False, qos=1)
+infot.wait_for_publish()
+
+#Stay running so we can see message arrive
+time.sleep(5)
+print("Commands %d, messages received %d"%(len(j), replies - 1))
+if (first != 0):
+    print("First reply after %d ms"%((first - sent) * 1000))
@@ -0,0 +1,170 @@
+# IoT Device Listen with CBOR decode
+# Jon Durrant - 19-Oct-2026
+#
+# Listens and prints all messages on Topic:
+# TNG/<<device>>/+
+# Payloads on topics ending /cbor are decoded and shown as JSON, with
+# the CBOR and JSON sizes for comparison.
+# Takes <<device>> as first parameter on command line
+# Optionally "on" or "off" as second parameter to send a CBOR LED request,
+# "get" to send a twin GET on STATE/GET/cbor, the reply arrives on
+# STATE/UPD/cbor, or "set" then "on" or "off" to send a twin SET as
+# {"state":{"on":..}} on STATE/SET/cbor, the twin replies on STATE/UPD
+# Experts following env variables to be set
+# MQTT_CLIENT
+# MQTT_USER
+# MQTT_PASSWD
+# MQTT_HOST
+# MQTT_PORT
+
+import paho.mqtt.client as mqtt
+import json
+import struct
+import time
+import sys
+import os
+
+
+# Decode one CBOR item from data at pos, returns (value, next pos)
+def cborDecode(data, pos=0):
+    ib = data[pos]
+    major = ib >> 5
+    info = ib & 0x1F
+    pos += 1
+    if info < 24:
+        val = info
+    elif info <= 27:
+        n = 1 << (info - 24)
+        raw = data[pos:pos+n]
+        val = int.from_bytes(raw, "big")
+        pos += n
+    else:
+        raise ValueError("Indefinite length not supported")
+
+    if major == 0:
+        return val, pos
+    if major == 1:
+        return -1 - val, pos
+    if major == 2:
+        return data[pos:pos+val], pos + val
+    if major == 3:
+        return data[pos:pos+val].decode("utf-8"), pos + val
+    if major == 4:
+        arr = []
+        for i in range(val):
+            item, pos = cborDecode(data, pos)
+            arr.append(item)
+        return arr, pos
+    if major == 5:
+        m = {}
+        for i in range(val):
+            k, pos = cborDecode(data, pos)
+            v, pos = cborDecode(data, pos)
+            m[k] = v
+        return m, pos
+    if major == 6:
+        return cborDecode(data, pos)
+    if info == 20:
+        return False, pos
+    if info == 21:
+        return True, pos
+    if info == 22:
+        return None, pos
+    if info == 26:
+        return struct.unpack(">f", raw)[0], pos
+    if info == 27:
+        return struct.unpack(">d", raw)[0], pos
+    raise ValueError("Unknown simple value %d"%info)
+
+
+# Encode maps of strings to booleans or further maps, enough for
+# LED requests and twin SETs
+def cborEncodeBoolMap(m):
+    out = bytes([0xA0 | len(m)])
+    for k, v in m.items():
+        kb = k.encode("utf-8")
+        out += bytes([0x60 | len(kb)]) + kb
+        if isinstance(v, dict):
+            out += cborEncodeBoolMap(v)
+        else:
+            out += bytes([0xF5 if v else 0xF4])
+    return out
+
+
+#Check we have a target as a parameter on command line
+if (len(sys.argv) < 2):
+    print("Require target ID as parater")
+    sys.exit()
+targetId = sys.argv[1]
+
+# Grab environment variables
+clientId=os.environ.get("MQTT_CLIENT")
+user=os.environ.get("MQTT_USER")
+passwd=os.environ.get("MQTT_PASSWD")
+host= os.environ.get("MQTT_HOST")
+port=int(os.environ.get("MQTT_PORT"))
+print("MQTT %s:%d"%(host,port))
+if (len(clientId) > 6):
+   print("Client: %s..."%clientId[0:4])
+else: 
+   print("Client: %s..."%clientId)   
+if (len(user) > 6):
+   print("User: %s..."%user[0:4])
+else:
+    print("User: %s"%user)    
+
+#Set up topic name
+devTopics = "TNG/" + targetId + "/#"
+ledTopic = "TNG/" + targetId + "/TPC/LED/req/cbor"
+getTopic = "TNG/" + targetId + "/STATE/GET/cbor"
+setTopic = "TNG/" + targetId + "/STATE/SET/cbor"
+
+# The callback for when the client receives a CONNACK response from the broker.
+def on_connect(client, userdata, flags, rc):
+    print("Connected with result code "+str(rc))
+
+    
+# The callback for when a PUBLISH message is received from the server.
+def on_message(client, userdata, msg):
+    if msg.topic.endswith("/cbor"):
+        try:
+            val, end = cborDecode(msg.payload)
+            j = json.dumps(val)
+            print("Rcv topic=%s cbor=%dB json=%dB msg=%s"%(
+                msg.topic, len(msg.payload), len(j), j))
+        except (ValueError, IndexError) as e:
+            print("Rcv topic=%s bad CBOR %s: %s"%(msg.topic, str(e), msg.payload.hex()))
+    else:
+        print("Rcv topic=" +msg.topic+" msg="+str(msg.payload))
+
+# Connect to the broker
+client = mqtt.Client(client_id=clientId)
+client.username_pw_set(username=user, password=passwd)
+client.on_connect = on_connect
+client.on_message = on_message
+client.connect(host, port, 60)
+
+#Maintain connection loop in thread
+client.loop_start()
+
+#Subscribe to the device topics so we can see what was sent
+client.subscribe( devTopics )
+
+#Optionally send a CBOR LED request or twin GET or SET
+if (len(sys.argv) > 2):
+    if (sys.argv[2] == "get"):
+        topic = getTopic
+        p = b""
+    elif (sys.argv[2] == "set"):
+        topic = setTopic
+        p = cborEncodeBoolMap({'state': {'on': (len(sys.argv) > 3) and (sys.argv[3] == "on")}})
+    else:
+        topic = ledTopic
+        p = cborEncodeBoolMap({'on': sys.argv[2] == "on"})
+    print("Publishing CBOR message %s to %s"%(p.hex(), topic))
+    infot = client.publish(topic, p, retain=False, qos=1)
+    infot.wait_for_publish()
+
+#Stay running so we can see message arrive
+while [True]:
+    time.sleep(30)
@@ -0,0 +1,84 @@
+/*
+ * BatchErrors.cpp
+ *
+ * Collects the index of each malformed entry in a batched command
+ * array so they can be reported back as one JSON message,
+ * e.g. {"bad":[1,3]}
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "BatchErrors.h"
+#include "json-maker/json-maker.h"
+
+/***
+ * Constructor
+ */
+BatchErrors::BatchErrors() {
+	// NOP
+}
+
+/***
+ * Destructor
+ */
+BatchErrors::~BatchErrors() {
+	// NOP
+}
+
+/***
+ * Forget all recorded entries
+ */
+void BatchErrors::clear(){
+	xCount = 0;
+}
+
+/***
+ * Record a malformed entry
+ * @param index - position of entry within the batch
+ */
+void BatchErrors::add(uint16_t index){
+	if (xCount < BATCH_MAX_ERRORS){
+		xIndex[xCount] = index;
+	}
+	xCount++;
+}
+
+/***
+ * Number of malformed entries
+ * @return
+ */
+uint16_t BatchErrors::count(){
+	return xCount;
+}
+
+/***
+ * Write the report as JSON
+ * @param buf - buffer to write to
+ * @param len - length of buffer
+ * @return length of json or zero if we ran out of space
+ */
+unsigned int BatchErrors::json(char *buf, unsigned int len){
+	size_t remLen = len;
+	char *p = buf;
+	uint16_t n = xCount;
+
+	if (n > BATCH_MAX_ERRORS){
+		n = BATCH_MAX_ERRORS;
+	}
+
+	p = json_objOpen(p, NULL, &remLen);
+	p = json_arrOpen(p, "bad", &remLen);
+	for (uint16_t i=0; i < n; i++){
+		p = json_uint(p, NULL, xIndex[i], &remLen);
+	}
+	p = json_arrClose(p, &remLen);
+	p = json_uint(p, "count", xCount, &remLen);
+	p = json_objClose(p, &remLen);
+	p = json_end(p, &remLen);
+
+	if (remLen == 0){
+		return 0;
+	}
+	return p - buf;
+}
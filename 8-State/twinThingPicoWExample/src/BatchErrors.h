@@ -0,0 +1,65 @@
+/*
+ * BatchErrors.h
+ *
+ * Collects the index of each malformed entry in a batched command
+ * array so they can be reported back as one JSON message,
+ * e.g. {"bad":[1,3]}
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _BATCHERRORS_H_
+#define _BATCHERRORS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//Number of bad indexes recorded, further ones are only counted
+#ifndef BATCH_MAX_ERRORS
+#define BATCH_MAX_ERRORS 	8
+#endif
+
+class BatchErrors {
+public:
+	/***
+	 * Constructor
+	 */
+	BatchErrors();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~BatchErrors();
+
+	/***
+	 * Forget all recorded entries
+	 */
+	void clear();
+
+	/***
+	 * Record a malformed entry
+	 * @param index - position of entry within the batch
+	 */
+	void add(uint16_t index);
+
+	/***
+	 * Number of malformed entries
+	 * @return
+	 */
+	uint16_t count();
+
+	/***
+	 * Write the report as JSON
+	 * @param buf - buffer to write to
+	 * @param len - length of buffer
+	 * @return length of json or zero if we ran out of space
+	 */
+	unsigned int json(char *buf, unsigned int len);
+
+private:
+	uint16_t xIndex[BATCH_MAX_ERRORS];
+	uint16_t xCount = 0;
+};
+
+#endif /* _BATCHERRORS_H_ */
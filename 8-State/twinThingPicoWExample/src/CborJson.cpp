@@ -0,0 +1,176 @@
+/*
+ * CborJson.cpp
+ *
+ * Convert state documents between JSON and CBOR, so the CBOR topics
+ * carry exactly what the JSON twin topics do, every slot of the State
+ * and its base classes included, and share the same SET path.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CborJson.h"
+#include <string.h>
+#include "json-maker/json-maker.h"
+
+/***
+ * Write a parsed JSON value as CBOR, objects become maps
+ * @param json - parsed JSON value
+ * @param w - writer
+ * @return false if out of space
+ */
+bool CborJson::fromJson(json_t const *json, CborWriter &w){
+	json_t const *jp;
+	size_t count = 0;
+
+	switch(json_getType(json)){
+		case JSON_OBJ:
+		case JSON_ARRAY:
+			for (jp = json_getChild(json); jp != NULL; jp = json_getSibling(jp)){
+				count++;
+			}
+			if (json_getType(json) == JSON_OBJ){
+				w.map(count);
+			} else {
+				w.array(count);
+			}
+			for (jp = json_getChild(json); jp != NULL; jp = json_getSibling(jp)){
+				if (json_getType(json) == JSON_OBJ){
+					w.text(json_getName(jp));
+				}
+				if (!fromJson(jp, w)){
+					return false;
+				}
+			}
+			break;
+		case JSON_TEXT:
+			w.text(json_getValue(json));
+			break;
+		case JSON_BOOLEAN:
+			w.boolean(json_getBoolean(json));
+			break;
+		case JSON_INTEGER:
+			w.integer(json_getInteger(json));
+			break;
+		case JSON_REAL:
+			w.real(json_getReal(json));
+			break;
+		default:
+			w.null();
+			break;
+	}
+	return w.ok();
+}
+
+/***
+ * Convert a CBOR item to JSON text
+ * @param cbor - CBOR data
+ * @param len - length of data
+ * @param buf - buffer to write JSON to
+ * @param bufLen - length of buffer
+ * @return length of JSON, zero if malformed, unsupported or out of space
+ */
+unsigned int CborJson::toJson(const uint8_t *cbor, size_t len,
+		char *buf, unsigned int bufLen){
+	CborReader r(cbor, len);
+	size_t remLen = bufLen;
+
+	char *p = item(r, NULL, buf, &remLen, 0);
+	if ((p == NULL) || (r.position() != len)){
+		return 0;
+	}
+	p = json_end(p, &remLen);
+	if (remLen == 0){
+		return 0;
+	}
+	return p - buf;
+}
+
+/***
+ * Write the next CBOR item as a named JSON value
+ * @param r - reader positioned at the item
+ * @param name - JSON name, NULL within an array or at the top
+ * @param p - position to write to, NULL once an error is found
+ * @param remLen - remaining length of buffer, updated
+ * @param depth - nesting depth
+ * @return next write position, NULL on error
+ */
+char *CborJson::item(CborReader &r, const char *name, char *p,
+		size_t *remLen, uint8_t depth){
+	char str[CBOR_JSON_TEXT_LEN + 1];
+	size_t count;
+	bool b;
+	int64_t i;
+	double d;
+
+	if (depth >= CBOR_MAX_DEPTH){
+		return NULL;
+	}
+
+	switch(r.peek()){
+		case CborMap:
+			r.map(count);
+			p = json_objOpen(p, name, remLen);
+			for (size_t n=0; n < count; n++){
+				char key[CBOR_JSON_TEXT_LEN + 1];
+				if (!text(r, key)){
+					return NULL;
+				}
+				p = item(r, key, p, remLen, depth + 1);
+				if (p == NULL){
+					return NULL;
+				}
+			}
+			return json_objClose(p, remLen);
+		case CborArray:
+			r.array(count);
+			p = json_arrOpen(p, name, remLen);
+			for (size_t n=0; n < count; n++){
+				p = item(r, NULL, p, remLen, depth + 1);
+				if (p == NULL){
+					return NULL;
+				}
+			}
+			return json_arrClose(p, remLen);
+		case CborText:
+			if (!text(r, str)){
+				return NULL;
+			}
+			return json_str(p, name, str, remLen);
+		case CborUInt:
+		case CborNInt:
+			r.integer(i);
+			return json_long(p, name, (long)i, remLen);
+		case CborSimple:
+			if (r.boolean(b)){
+				return json_bool(p, name, b, remLen);
+			}
+			if (r.real(d)){
+				return json_double(p, name, d, remLen);
+			}
+			if (!r.skip()){
+				return NULL;
+			}
+			return json_null(p, name, remLen);
+		default:
+			return NULL;
+	}
+}
+
+/***
+ * Read a CBOR text string into a terminated buffer
+ * @param r - reader
+ * @param str - buffer of CBOR_JSON_TEXT_LEN + 1
+ * @return false if not text or too long
+ */
+bool CborJson::text(CborReader &r, char *str){
+	const char *s;
+	size_t len;
+
+	if (!r.text(s, len) || (len > CBOR_JSON_TEXT_LEN)){
+		return false;
+	}
+	memcpy(str, s, len);
+	str[len] = 0;
+	return true;
+}
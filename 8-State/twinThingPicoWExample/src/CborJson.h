@@ -0,0 +1,69 @@
+/*
+ * CborJson.h
+ *
+ * Convert state documents between JSON and CBOR, so the CBOR topics
+ * carry exactly what the JSON twin topics do, every slot of the State
+ * and its base classes included, and share the same SET path.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _CBORJSON_H_
+#define _CBORJSON_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tiny-json.h"
+#include "CborWriter.h"
+#include "CborReader.h"
+
+//Longest CBOR key or text value converted to JSON
+#ifndef CBOR_JSON_TEXT_LEN
+#define CBOR_JSON_TEXT_LEN 	64
+#endif
+
+class CborJson {
+public:
+	/***
+	 * Write a parsed JSON value as CBOR, objects become maps
+	 * @param json - parsed JSON value
+	 * @param w - writer
+	 * @return false if out of space
+	 */
+	static bool fromJson(json_t const *json, CborWriter &w);
+
+	/***
+	 * Convert a CBOR item to JSON text
+	 * @param cbor - CBOR data
+	 * @param len - length of data
+	 * @param buf - buffer to write JSON to
+	 * @param bufLen - length of buffer
+	 * @return length of JSON, zero if malformed, unsupported or out of space
+	 */
+	static unsigned int toJson(const uint8_t *cbor, size_t len,
+			char *buf, unsigned int bufLen);
+
+private:
+	/***
+	 * Write the next CBOR item as a named JSON value
+	 * @param r - reader positioned at the item
+	 * @param name - JSON name, NULL within an array or at the top
+	 * @param p - position to write to, NULL once an error is found
+	 * @param remLen - remaining length of buffer, updated
+	 * @param depth - nesting depth
+	 * @return next write position, NULL on error
+	 */
+	static char *item(CborReader &r, const char *name, char *p,
+			size_t *remLen, uint8_t depth);
+
+	/***
+	 * Read a CBOR text string into a terminated buffer
+	 * @param r - reader
+	 * @param str - buffer of CBOR_JSON_TEXT_LEN + 1
+	 * @return false if not text or too long
+	 */
+	static bool text(CborReader &r, char *str);
+};
+
+#endif /* _CBORJSON_H_ */
@@ -0,0 +1,280 @@
+/*
+ * CborReader.cpp
+ *
+ * Minimal CBOR (RFC 8949) decoder reading in place from a buffer.
+ * No heap is used. Definite length items only, which is all CborWriter
+ * produces.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CborReader.h"
+#include <string.h>
+
+#define CBOR_FALSE 	20
+#define CBOR_TRUE 	21
+#define CBOR_FLOAT32 26
+#define CBOR_FLOAT64 27
+
+/***
+ * Constructor
+ * @param buf - CBOR data
+ * @param len - length of data
+ */
+CborReader::CborReader(const uint8_t *buf, size_t len) {
+	pBuf = buf;
+	xLen = len;
+}
+
+/***
+ * Destructor
+ */
+CborReader::~CborReader() {
+	// NOP
+}
+
+/***
+ * Type of the next item
+ * @return CborEnd if no more data
+ */
+CborType CborReader::peek(){
+	if (xPos >= xLen){
+		return CborEnd;
+	}
+	return (CborType)(pBuf[xPos] >> 5);
+}
+
+/***
+ * Read the start of a map
+ * @param count - number of key and value pairs that follow
+ * @return false if next item is not a map
+ */
+bool CborReader::map(size_t &count){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+
+	if (!head(major, info, val) || (major != CborMap)){
+		xPos = start;
+		return false;
+	}
+	count = val;
+	return true;
+}
+
+/***
+ * Read the start of an array
+ * @param count - number of items that follow
+ * @return false if next item is not an array
+ */
+bool CborReader::array(size_t &count){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+
+	if (!head(major, info, val) || (major != CborArray)){
+		xPos = start;
+		return false;
+	}
+	count = val;
+	return true;
+}
+
+/***
+ * Read a text string. Not copied or terminated
+ * @param str - set to start of string within the buffer
+ * @param len - set to length of the string
+ * @return false if next item is not text
+ */
+bool CborReader::text(const char * &str, size_t &len){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+
+	if (!head(major, info, val) || (major != CborText) ||
+			(val > (xLen - xPos))){
+		xPos = start;
+		return false;
+	}
+	str = (const char *)&pBuf[xPos];
+	len = val;
+	xPos += val;
+	return true;
+}
+
+/***
+ * Read a boolean
+ * @param b
+ * @return false if next item is not a boolean
+ */
+bool CborReader::boolean(bool &b){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+
+	if (!head(major, info, val) || (major != CborSimple) ||
+			((info != CBOR_TRUE) && (info != CBOR_FALSE))){
+		xPos = start;
+		return false;
+	}
+	b = (info == CBOR_TRUE);
+	return true;
+}
+
+/***
+ * Read an integer
+ * @param i
+ * @return false if next item is not an integer
+ */
+bool CborReader::integer(int64_t &i){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+
+	if (!head(major, info, val) || (val > INT64_MAX) ||
+			((major != CborUInt) && (major != CborNInt))){
+		xPos = start;
+		return false;
+	}
+	if (major == CborNInt){
+		i = -1 - (int64_t)val;
+	} else {
+		i = (int64_t)val;
+	}
+	return true;
+}
+
+/***
+ * Read a number, accepts integers and floats
+ * @param d
+ * @return false if next item is not a number
+ */
+bool CborReader::real(double &d){
+	uint8_t major, info;
+	uint64_t val;
+	size_t start = xPos;
+	int64_t i;
+
+	if (integer(i)){
+		d = (double)i;
+		return true;
+	}
+	if (!head(major, info, val) || (major != CborSimple)){
+		xPos = start;
+		return false;
+	}
+	if (info == CBOR_FLOAT64){
+		memcpy(&d, &val, sizeof(d));
+		return true;
+	}
+	if (info == CBOR_FLOAT32){
+		uint32_t bits = (uint32_t)val;
+		float f;
+		memcpy(&f, &bits, sizeof(f));
+		d = f;
+		return true;
+	}
+	xPos = start;
+	return false;
+}
+
+/***
+ * Skip the next item including any contents
+ * @return false if data is malformed
+ */
+bool CborReader::skip(){
+	return skip(0);
+}
+
+/***
+ * Number of bytes read
+ * @return
+ */
+size_t CborReader::position(){
+	return xPos;
+}
+
+/***
+ * Skip the next item
+ * @param depth - current nesting depth
+ * @return false if data is malformed
+ */
+bool CborReader::skip(uint8_t depth){
+	uint8_t major, info;
+	uint64_t val;
+
+	if ((depth > CBOR_MAX_DEPTH) || !head(major, info, val)){
+		return false;
+	}
+	switch(major){
+	case CborBytes:
+	case CborText:
+		if (val > (xLen - xPos)){
+			return false;
+		}
+		xPos += val;
+		return true;
+	case CborMap:
+		val = val * 2;
+		// fall through
+	case CborArray:
+		for (uint64_t i=0; i < val; i++){
+			if (!skip(depth + 1)){
+				return false;
+			}
+		}
+		return true;
+	case CborTag:
+		return skip(depth + 1);
+	default:
+		return true;
+	}
+}
+
+/***
+ * Read the initial byte and argument of an item
+ * @param major - major type
+ * @param info - additional info from initial byte
+ * @param val - argument
+ * @return false if out of data or indefinite length
+ */
+bool CborReader::head(uint8_t &major, uint8_t &info, uint64_t &val){
+	size_t n;
+
+	if (xPos >= xLen){
+		return false;
+	}
+	major = pBuf[xPos] >> 5;
+	info = pBuf[xPos] & 0x1F;
+	xPos++;
+
+	if (info < 24){
+		val = info;
+		return true;
+	}
+	switch(info){
+	case 24:
+		n = 1;
+		break;
+	case 25:
+		n = 2;
+		break;
+	case 26:
+		n = 4;
+		break;
+	case 27:
+		n = 8;
+		break;
+	default:
+		return false;
+	}
+	if (n > (xLen - xPos)){
+		return false;
+	}
+	val = 0;
+	for (size_t i=0; i < n; i++){
+		val = (val << 8) | pBuf[xPos++];
+	}
+	return true;
+}
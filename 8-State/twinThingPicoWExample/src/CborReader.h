@@ -0,0 +1,131 @@
+/*
+ * CborReader.h
+ *
+ * Minimal CBOR (RFC 8949) decoder reading in place from a buffer.
+ * No heap is used. Definite length items only, which is all CborWriter
+ * produces.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _CBORREADER_H_
+#define _CBORREADER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef CBOR_MAX_DEPTH
+#define CBOR_MAX_DEPTH 	8
+#endif
+
+enum CborType {
+	CborUInt,
+	CborNInt,
+	CborBytes,
+	CborText,
+	CborArray,
+	CborMap,
+	CborTag,
+	CborSimple,
+	CborEnd
+};
+
+class CborReader {
+public:
+	/***
+	 * Constructor
+	 * @param buf - CBOR data
+	 * @param len - length of data
+	 */
+	CborReader(const uint8_t *buf, size_t len);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~CborReader();
+
+	/***
+	 * Type of the next item
+	 * @return CborEnd if no more data
+	 */
+	CborType peek();
+
+	/***
+	 * Read the start of a map
+	 * @param count - number of key and value pairs that follow
+	 * @return false if next item is not a map
+	 */
+	bool map(size_t &count);
+
+	/***
+	 * Read the start of an array
+	 * @param count - number of items that follow
+	 * @return false if next item is not an array
+	 */
+	bool array(size_t &count);
+
+	/***
+	 * Read a text string. Not copied or terminated
+	 * @param str - set to start of string within the buffer
+	 * @param len - set to length of the string
+	 * @return false if next item is not text
+	 */
+	bool text(const char * &str, size_t &len);
+
+	/***
+	 * Read a boolean
+	 * @param b
+	 * @return false if next item is not a boolean
+	 */
+	bool boolean(bool &b);
+
+	/***
+	 * Read an integer
+	 * @param i
+	 * @return false if next item is not an integer
+	 */
+	bool integer(int64_t &i);
+
+	/***
+	 * Read a number, accepts integers and floats
+	 * @param d
+	 * @return false if next item is not a number
+	 */
+	bool real(double &d);
+
+	/***
+	 * Skip the next item including any contents
+	 * @return false if data is malformed
+	 */
+	bool skip();
+
+	/***
+	 * Number of bytes read
+	 * @return
+	 */
+	size_t position();
+
+private:
+	/***
+	 * Read the initial byte and argument of an item
+	 * @param major - major type
+	 * @param info - additional info from initial byte
+	 * @param val - argument
+	 * @return false if out of data or indefinite length
+	 */
+	bool head(uint8_t &major, uint8_t &info, uint64_t &val);
+
+	/***
+	 * Skip the next item
+	 * @param depth - current nesting depth
+	 * @return false if data is malformed
+	 */
+	bool skip(uint8_t depth);
+
+	const uint8_t *pBuf = NULL;
+	size_t xLen = 0;
+	size_t xPos = 0;
+};
+
+#endif /* _CBORREADER_H_ */
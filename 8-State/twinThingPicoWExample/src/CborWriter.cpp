@@ -0,0 +1,195 @@
+/*
+ * CborWriter.cpp
+ *
+ * Minimal CBOR (RFC 8949) encoder writing into a caller supplied buffer.
+ * No heap is used. Covers the types used for state and command payloads:
+ * maps, arrays, text, booleans, integers and doubles.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CborWriter.h"
+#include <string.h>
+
+#define CBOR_UINT 	0
+#define CBOR_NINT 	1
+#define CBOR_TEXT 	3
+#define CBOR_ARRAY 	4
+#define CBOR_MAP 	5
+#define CBOR_SIMPLE 7
+
+#define CBOR_FALSE 	20
+#define CBOR_TRUE 	21
+#define CBOR_NULL 	22
+#define CBOR_FLOAT64 27
+
+/***
+ * Constructor
+ * @param buf - buffer to write to
+ * @param len - length of buffer
+ */
+CborWriter::CborWriter(uint8_t *buf, size_t len) {
+	pBuf = buf;
+	xLen = len;
+}
+
+/***
+ * Destructor
+ */
+CborWriter::~CborWriter() {
+	// NOP
+}
+
+/***
+ * Start a map, must be followed by count key and value pairs
+ * @param count - number of pairs
+ * @return false if out of space
+ */
+bool CborWriter::map(size_t count){
+	return head(CBOR_MAP, count);
+}
+
+/***
+ * Start an array, must be followed by count items
+ * @param count - number of items
+ * @return false if out of space
+ */
+bool CborWriter::array(size_t count){
+	return head(CBOR_ARRAY, count);
+}
+
+/***
+ * Write a text string
+ * @param str - zero terminated string
+ * @return false if out of space
+ */
+bool CborWriter::text(const char *str){
+	return text(str, strlen(str));
+}
+
+/***
+ * Write a text string
+ * @param str - string, need not be terminated
+ * @param len - length of string
+ * @return false if out of space
+ */
+bool CborWriter::text(const char *str, size_t len){
+	if (!head(CBOR_TEXT, len)){
+		return false;
+	}
+	return put(str, len);
+}
+
+/***
+ * Write a boolean
+ * @param b
+ * @return false if out of space
+ */
+bool CborWriter::boolean(bool b){
+	uint8_t v = (CBOR_SIMPLE << 5) | (b ? CBOR_TRUE : CBOR_FALSE);
+	return put(&v, 1);
+}
+
+/***
+ * Write a signed integer in the smallest encoding
+ * @param i
+ * @return false if out of space
+ */
+bool CborWriter::integer(int64_t i){
+	if (i < 0){
+		return head(CBOR_NINT, (uint64_t)(-1 - i));
+	}
+	return head(CBOR_UINT, (uint64_t)i);
+}
+
+/***
+ * Write a double as a 64 bit float
+ * @param d
+ * @return false if out of space
+ */
+bool CborWriter::real(double d){
+	uint64_t bits;
+	uint8_t b[9];
+
+	memcpy(&bits, &d, sizeof(bits));
+	b[0] = (CBOR_SIMPLE << 5) | CBOR_FLOAT64;
+	for (int i=0; i < 8; i++){
+		b[8 - i] = (uint8_t)(bits >> (8 * i));
+	}
+	return put(b, sizeof(b));
+}
+
+/***
+ * Write null
+ * @return false if out of space
+ */
+bool CborWriter::null(){
+	uint8_t v = (CBOR_SIMPLE << 5) | CBOR_NULL;
+	return put(&v, 1);
+}
+
+/***
+ * Number of bytes written
+ * @return
+ */
+size_t CborWriter::length(){
+	return xPos;
+}
+
+/***
+ * Has everything written so far fitted in the buffer
+ * @return
+ */
+bool CborWriter::ok(){
+	return xOk;
+}
+
+/***
+ * Write the initial byte and argument of an item
+ * @param major - major type 0 to 7
+ * @param val - argument
+ * @return false if out of space
+ */
+bool CborWriter::head(uint8_t major, uint64_t val){
+	uint8_t b[9];
+	size_t n;
+
+	major = major << 5;
+	if (val < 24){
+		b[0] = major | (uint8_t)val;
+		n = 0;
+	} else if (val <= 0xFF){
+		b[0] = major | 24;
+		n = 1;
+	} else if (val <= 0xFFFF){
+		b[0] = major | 25;
+		n = 2;
+	} else if (val <= 0xFFFFFFFFULL){
+		b[0] = major | 26;
+		n = 4;
+	} else {
+		b[0] = major | 27;
+		n = 8;
+	}
+	for (size_t i=0; i < n; i++){
+		b[n - i] = (uint8_t)(val >> (8 * i));
+	}
+	return put(b, n + 1);
+}
+
+/***
+ * Write raw bytes
+ * @param data
+ * @param len
+ * @return false if out of space
+ */
+bool CborWriter::put(const void *data, size_t len){
+	if (!xOk || (len > (xLen - xPos))){
+		xOk = false;
+		return false;
+	}
+	memcpy(&pBuf[xPos], data, len);
+	xPos += len;
+	return true;
+}
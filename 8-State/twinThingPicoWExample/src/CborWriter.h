@@ -0,0 +1,123 @@
+/*
+ * CborWriter.h
+ *
+ * Minimal CBOR (RFC 8949) encoder writing into a caller supplied buffer.
+ * No heap is used. Covers the types used for state and command payloads:
+ * maps, arrays, text, booleans, integers and doubles.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _CBORWRITER_H_
+#define _CBORWRITER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+class CborWriter {
+public:
+	/***
+	 * Constructor
+	 * @param buf - buffer to write to
+	 * @param len - length of buffer
+	 */
+	CborWriter(uint8_t *buf, size_t len);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~CborWriter();
+
+	/***
+	 * Start a map, must be followed by count key and value pairs
+	 * @param count - number of pairs
+	 * @return false if out of space
+	 */
+	bool map(size_t count);
+
+	/***
+	 * Start an array, must be followed by count items
+	 * @param count - number of items
+	 * @return false if out of space
+	 */
+	bool array(size_t count);
+
+	/***
+	 * Write a text string
+	 * @param str - zero terminated string
+	 * @return false if out of space
+	 */
+	bool text(const char *str);
+
+	/***
+	 * Write a text string
+	 * @param str - string, need not be terminated
+	 * @param len - length of string
+	 * @return false if out of space
+	 */
+	bool text(const char *str, size_t len);
+
+	/***
+	 * Write a boolean
+	 * @param b
+	 * @return false if out of space
+	 */
+	bool boolean(bool b);
+
+	/***
+	 * Write a signed integer in the smallest encoding
+	 * @param i
+	 * @return false if out of space
+	 */
+	bool integer(int64_t i);
+
+	/***
+	 * Write a double as a 64 bit float
+	 * @param d
+	 * @return false if out of space
+	 */
+	bool real(double d);
+
+	/***
+	 * Write null
+	 * @return false if out of space
+	 */
+	bool null();
+
+	/***
+	 * Number of bytes written
+	 * @return
+	 */
+	size_t length();
+
+	/***
+	 * Has everything written so far fitted in the buffer
+	 * @return
+	 */
+	bool ok();
+
+private:
+	/***
+	 * Write the initial byte and argument of an item
+	 * @param major - major type 0 to 7
+	 * @param val - argument
+	 * @return false if out of space
+	 */
+	bool head(uint8_t major, uint64_t val);
+
+	/***
+	 * Write raw bytes
+	 * @param data
+	 * @param len
+	 * @return false if out of space
+	 */
+	bool put(const void *data, size_t len);
+
+	uint8_t *pBuf = NULL;
+	size_t xLen = 0;
+	size_t xPos = 0;
+	bool xOk = true;
+};
+
+#endif /* _CBORWRITER_H_ */
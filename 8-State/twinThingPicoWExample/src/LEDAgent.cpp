@@ -9,6 +9,14 @@
 
 #include "LEDAgent.h"
 #include "MQTTTopicHelper.h"
+#include "CborWriter.h"
+#include "CborReader.h"
+
+#if LED_PAYLOAD_CBOR
+#define LED_STATE_TOPIC MQTT_TOPIC_LED_STATE_CBOR
+#else
+#define LED_STATE_TOPIC MQTT_TOPIC_LED_STATE
+#endif
 
 //Local enumerator of the actions to be queued
 enum LEDAction {LEDOff, LEDOn, LEDToggle};
@@ -50,9 +58,17 @@ LEDAgent::LEDAgent(uint8_t ledGP, uint8_t spstGP, MQTTInterface *interface, LEDS
 	//Construct the TOPIC for status messages
 	if (pInterface != NULL){
 		if (pTopicLedState == NULL){
-			pTopicLedState = (char *)pvPortMalloc( MQTTTopicHelper::lenThingTopic(pInterface->getId(), MQTT_TOPIC_LED_STATE));
+			pTopicLedState = (char *)pvPortMalloc( MQTTTopicHelper::lenThingTopic(pInterface->getId(), LED_STATE_TOPIC));
 			if (pTopicLedState != NULL){
-				MQTTTopicHelper::genThingTopic(pTopicLedState, pInterface->getId(), MQTT_TOPIC_LED_STATE);
+				MQTTTopicHelper::genThingTopic(pTopicLedState, pInterface->getId(), LED_STATE_TOPIC);
+			} else {
+				LogError( ("Unable to allocate topic") );
+			}
+		}
+		if (pTopicLedErr == NULL){
+			pTopicLedErr = (char *)pvPortMalloc( MQTTTopicHelper::lenThingTopic(pInterface->getId(), MQTT_TOPIC_LED_ERR));
+			if (pTopicLedErr != NULL){
+				MQTTTopicHelper::genThingTopic(pTopicLedErr, pInterface->getId(), MQTT_TOPIC_LED_ERR);
 			} else {
 				LogError( ("Unable to allocate topic") );
 			}
@@ -77,6 +93,10 @@ LEDAgent::~LEDAgent() {
 		vPortFree(pTopicLedState);
 		pTopicLedState = NULL;
 	}
+	if (pTopicLedErr != NULL){
+		vPortFree(pTopicLedErr);
+		pTopicLedErr = NULL;
+	}
 	if (xBuffer != NULL){
 		vMessageBufferDelete(xBuffer);
 	}
@@ -114,6 +134,8 @@ void LEDAgent::setOn(bool on){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -126,6 +148,8 @@ void LEDAgent::toggle(){
 	BaseType_t res = xQueueSendToBack(xCmdQ, (void *)&action, 0);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wake();
 	}
 }
 
@@ -137,6 +161,8 @@ void LEDAgent::intToggle(){
 	BaseType_t res = xQueueSendToFrontFromISR(xCmdQ, (void *)&action, NULL);
 	if (res != pdTRUE){
 		LogWarn(("Queue is full\n"));
+	} else {
+		wakeFromISR();
 	}
 }
 
@@ -145,9 +171,7 @@ void LEDAgent::intToggle(){
   * Main Run Task for agent
   */
 void LEDAgent::run(){
-	BaseType_t res;
 	LEDAction action = LEDOff;
-	char jsonStr[LED_JSON_LEN];
 	size_t readLen;
 
 	if (xCmdQ == NULL){
@@ -155,19 +179,15 @@ void LEDAgent::run(){
 	}
 
 	while (true) { // Loop forever
-		readLen = xMessageBufferReceive(
-						 xBuffer,
-				         jsonStr,
-						 LED_JSON_LEN,
-						 0
-				    );
-		if (readLen > 0){
-			jsonStr[readLen] = 0;
-	        parseJSON(jsonStr);
+		while ((readLen = xMessageBufferReceive(xBuffer, xJsonStr, LED_JSON_LEN, 0)) > 0){
+			uint32_t start = time_us_32();
+			xJsonStr[readLen] = 0;
+	        if (parseJSON(xJsonStr)){
+	        	xApplyStart = start;
+	        }
 		}
 
-		res = xQueueReceive(xCmdQ, (void *)&action, 0);
-		if (res == pdTRUE){
+		while (xQueueReceive(xCmdQ, (void *)&action, 0) == pdTRUE){
 			switch(action){
 				case LEDOff:{
 					execLed(false);
@@ -182,8 +202,10 @@ void LEDAgent::run(){
 					break;
 				}
 			}
-			taskYIELD();
 		}
+
+		//Sleep until more work is queued
+		waitForWork();
 	}
 }
 
@@ -193,6 +215,10 @@ void LEDAgent::run(){
  * @param state
  */
 void LEDAgent::execLed(bool state){
+	if (xApplyStart != 0){
+		xApplyUs = time_us_32() - xApplyStart;
+		xApplyStart = 0;
+	}
 
 	if (state != xState){
 		gpio_put(xLedGP, state);
@@ -209,17 +235,27 @@ void LEDAgent::execLed(bool state){
  * Notify MQTT topic of state change
  */
 void LEDAgent::notify(){
+#if LED_PAYLOAD_CBOR
+	uint8_t payload[16];
+	CborWriter cbor(payload, sizeof(payload));
+	cbor.map(1);
+	cbor.text("on");
+	cbor.boolean(xState);
+	size_t payloadLen = cbor.length();
+#else
 	char payload[16];
 	if (xState){
 		sprintf(payload, "{\"on\"=True}");
 	} else {
 		sprintf(payload, "{\"on\"=False}");
 	}
+	size_t payloadLen = strlen(payload);
+#endif
 	if (pInterface != NULL){
 		pInterface->pubToTopic(
 			pTopicLedState,
 			payload,
-			strlen(payload),
+			payloadLen,
 			1,
 			false
 			);
@@ -233,28 +269,135 @@ void LEDAgent::notify(){
  * @return - words
  */
  configSTACK_DEPTH_TYPE LEDAgent::getMaxStackSize(){
-	 return 250;
+	 return 400;
  }
 
 
 /***
 * Parse a JSON string and add request to queue
 * @param str - JSON Strging
+* @return true if the LED was set
 */
-void LEDAgent::parseJSON(char *str){
+bool LEDAgent::parseJSON(char *str){
 	 json_t const* json = json_create( str, pJsonPool, LED_JSON_POOL);
 	 if ( !json ) {
 		 LogError(("Error json create."));
-		 return ;
+		 return false;
+	 }
+	 if ( JSON_ARRAY == json_getType( json ) ) {
+		 return parseBatch(json);
 	 }
-	 json_t const* on = json_getProperty( json, "on" );
-	 if ( !on || JSON_BOOLEAN != json_getType( on ) ) {
+
+	 bool b;
+	 if ( !readCmd( json, b ) ) {
 		 LogError(("Error, the on property is not found."));
-		 return ;
+		 return false;
+	 }
+
+	 //Drop stale commands before they reach the LED
+	 if ( !freshCmd( json ) ) {
+		 LogDebug(("Stale LED command dropped"));
+		 return false;
 	 }
-	 bool b = (int)json_getBoolean( on );
 
 	 setOn(b);
+	 return true;
+}
+
+/***
+ * Apply an array of commands as a single change. The last fresh
+ * command wins so the LED is set and published once
+ * @param json - parsed array
+ * @return true if the LED was set
+ */
+bool LEDAgent::parseBatch(json_t const *json){
+	json_t const *cmd;
+	uint16_t index = 0;
+	bool b;
+	bool last = false;
+	bool found = false;
+
+	//Check every entry before applying any
+	xBatchErrors.clear();
+	for (cmd = json_getChild( json ); cmd != NULL; cmd = json_getSibling( cmd )){
+		if ( !readCmd( cmd, b ) ) {
+			LogError(("Error, LED batch entry %d malformed", index));
+			xBatchErrors.add(index);
+		}
+		index++;
+	}
+	xBatchCmds += index;
+
+	if (xBatchErrors.count() > 0){
+		xBatchRejected++;
+		if ((pInterface != NULL) && (pTopicLedErr != NULL)){
+			unsigned int len = xBatchErrors.json(xErrStr, sizeof(xErrStr));
+			if (len > 0){
+				pInterface->pubToTopic(pTopicLedErr, xErrStr, len, 1, false);
+			}
+		}
+		return false;
+	}
+
+	for (cmd = json_getChild( json ); cmd != NULL; cmd = json_getSibling( cmd )){
+		readCmd( cmd, b );
+		if ( freshCmd( cmd ) ) {
+			last = b;
+			found = true;
+		}
+	}
+	if (!found){
+		LogDebug(("Stale LED batch dropped"));
+		return false;
+	}
+	xBatches++;
+	setOn(last);
+	return true;
+}
+
+/***
+ * Read a single command, checking property types
+ * @param json - command object
+ * @param on - set to the value of "on"
+ * @return false if the command is malformed
+ */
+bool LEDAgent::readCmd(json_t const *json, bool &on){
+	if ( JSON_OBJ != json_getType( json ) ) {
+		return false;
+	}
+	json_t const* jp = json_getProperty( json, "on" );
+	if ( !jp || JSON_BOOLEAN != json_getType( jp ) ) {
+		return false;
+	}
+	on = json_getBoolean( jp );
+
+	jp = json_getProperty( json, "seq" );
+	if ( jp && JSON_INTEGER != json_getType( jp ) ) {
+		return false;
+	}
+	jp = json_getProperty( json, "src" );
+	if ( jp && JSON_TEXT != json_getType( jp ) ) {
+		return false;
+	}
+	return true;
+}
+
+/***
+ * Check the command's sequence number, if it has one
+ * @param json - command object
+ * @return false if the command is stale
+ */
+bool LEDAgent::freshCmd(json_t const *json){
+	json_t const* seq = json_getProperty( json, "seq" );
+	if ( !seq ) {
+		return true;
+	}
+	json_t const* src = json_getProperty( json, "src" );
+	const char *srcStr = "";
+	if ( src ) {
+		srcStr = json_getValue( src );
+	}
+	return xSeq.accept(srcStr, strlen(srcStr), (uint32_t)json_getInteger( seq ));
 }
 
 
@@ -263,6 +406,11 @@ void LEDAgent::parseJSON(char *str){
  * @param jsonStr
  */
 void LEDAgent::addJSON(const void  *jsonStr, size_t len){
+	//Larger messages could never be received so would block the buffer
+	if (len > LED_JSON_LEN){
+		LogError(("JSON too long %d", len));
+		return;
+	}
 	if (xBuffer != NULL){
 		size_t res = xMessageBufferSend(
 			xBuffer,
@@ -272,8 +420,103 @@ void LEDAgent::addJSON(const void  *jsonStr, size_t len){
 
 		if (res != len){
 			LogError(("Failed to write"));
+		} else {
+			wake();
+		}
+	}
+}
+
+
+/***
+ * Add a CBOR action, a map holding the "on" boolean
+ * @param cbor - CBOR data
+ * @param len - length of data
+ */
+void LEDAgent::addCBOR(const void *cbor, size_t len){
+	CborReader reader((const uint8_t *)cbor, len);
+	size_t count;
+	const char *key;
+	size_t keyLen;
+	bool b;
+	bool found = false;
+	int64_t seq;
+	bool hasSeq = false;
+	const char *src = "";
+	size_t srcLen = 0;
+
+	if (!reader.map(count)){
+		LogError(("Error, CBOR is not a map."));
+		return;
+	}
+	for (size_t i=0; i < count; i++){
+		if (!reader.text(key, keyLen)){
+			return;
+		}
+		if ((keyLen == 2) && (memcmp(key, "on", 2) == 0) &&
+				reader.boolean(b)){
+			found = true;
+		} else if ((keyLen == 3) && (memcmp(key, "seq", 3) == 0) &&
+				reader.integer(seq)){
+			hasSeq = true;
+		} else if ((keyLen == 3) && (memcmp(key, "src", 3) == 0) &&
+				reader.text(src, srcLen)){
+			// Source noted
+		} else if (!reader.skip()){
+			return;
 		}
 	}
+	if (!found){
+		LogError(("Error, the on property is not found."));
+		return;
+	}
+
+	//Drop stale commands before they reach the LED
+	if (hasSeq && !xSeq.accept(src, srcLen, (uint32_t)seq)){
+		LogDebug(("Stale LED command dropped"));
+		return;
+	}
+	setOn(b);
+}
+
+/***
+ * Number of commands dropped as duplicate or out of order
+ * @return
+ */
+uint32_t LEDAgent::getDropped(){
+	return xSeq.getDropped();
+}
+
+/***
+ * Number of command arrays applied
+ * @return
+ */
+uint32_t LEDAgent::getBatches(){
+	return xBatches;
+}
+
+/***
+ * Number of commands received within arrays
+ * @return
+ */
+uint32_t LEDAgent::getBatchCmds(){
+	return xBatchCmds;
+}
+
+/***
+ * Number of command arrays rejected as malformed
+ * @return
+ */
+uint32_t LEDAgent::getBatchRejected(){
+	return xBatchRejected;
+}
+
+/***
+ * Time from the last JSON command being taken from the buffer to
+ * the LED being set
+ * @return microseconds
+ */
+uint32_t LEDAgent::getApplyUs(){
+	return xApplyUs;
 }
 
 
@@ -24,12 +24,22 @@
 
 #include "LEDState.h"
 #include "StateObserver.h"
+#include "SeqTracker.h"
+#include "BatchErrors.h"
 
 #define LED_QUEUE_LEN 	5
 #define MQTT_TOPIC_LED_STATE "LED/state"
+#define MQTT_TOPIC_LED_STATE_CBOR "LED/state/cbor"
+#define MQTT_TOPIC_LED_ERR "LED/err"
+
+//Publish LED state as CBOR rather than JSON
+#ifndef LED_PAYLOAD_CBOR
+#define LED_PAYLOAD_CBOR 0
+#endif
 #define LED_BUFFER_LEN 	256
-#define LED_JSON_LEN 	20
-#define LED_JSON_POOL 	5
+//Longest command, room for a batch array of several commands
+#define LED_JSON_LEN 	240
+#define LED_JSON_POOL 	32
 
 
 class LEDAgent : public Agent, public SwitchObserver, public StateObserver {
@@ -61,11 +71,52 @@ public:
 
 
 	/***
-	 * Add a JSON string action
+	 * Add a JSON string action. {"on":b} with optional "seq" number and
+	 * "src" name, stale commands are dropped. An array of commands is
+	 * applied as one change, if any entry is malformed none are applied
+	 * and the bad indexes are published to LED/err
 	 * @param jsonStr
 	 */
 	void addJSON(const void  *jsonStr, size_t len);
 
+	/***
+	 * Add a CBOR action, a map holding the "on" boolean
+	 * @param cbor - CBOR data
+	 * @param len - length of data
+	 */
+	void addCBOR(const void *cbor, size_t len);
+
+	/***
+	 * Number of commands dropped as duplicate or out of order
+	 * @return
+	 */
+	uint32_t getDropped();
+
+	/***
+	 * Number of command arrays applied
+	 * @return
+	 */
+	uint32_t getBatches();
+
+	/***
+	 * Number of commands received within arrays
+	 * @return
+	 */
+	uint32_t getBatchCmds();
+
+	/***
+	 * Number of command arrays rejected as malformed
+	 * @return
+	 */
+	uint32_t getBatchRejected();
+
+	/***
+	 * Time from the last JSON command being taken from the buffer to
+	 * the LED being set
+	 * @return microseconds
+	 */
+	uint32_t getApplyUs();
+
 	/***
 	 * Handle a short press from the switch
 	 * @param gp - GPIO number of the switch
@@ -112,8 +163,32 @@ private:
 	/***
 	 * Parse a JSON string and add request to queue
 	 * @param str - JSON Strging
+	 * @return true if the LED was set
+	 */
+	bool parseJSON(char *str);
+
+	/***
+	 * Apply an array of commands as a single change. The last fresh
+	 * command wins so the LED is set and published once
+	 * @param json - parsed array
+	 * @return true if the LED was set
 	 */
-	void parseJSON(char *str);
+	bool parseBatch(json_t const *json);
+
+	/***
+	 * Read a single command, checking property types
+	 * @param json - command object
+	 * @param on - set to the value of "on"
+	 * @return false if the command is malformed
+	 */
+	bool readCmd(json_t const *json, bool &on);
+
+	/***
+	 * Check the command's sequence number, if it has one
+	 * @param json - command object
+	 * @return false if the command is stale
+	 */
+	bool freshCmd(json_t const *json);
 
 	/***
 	 * Notify MQTT topic of state change
@@ -126,6 +201,9 @@ private:
 	// Topic to publish on
 	char * pTopicLedState = NULL;
 
+	// Topic to report malformed batches on
+	char * pTopicLedErr = NULL;
+
 	//State of the LED
 	bool xState = false;
 
@@ -146,9 +224,29 @@ private:
 	// Json decoding buffer
 	json_t pJsonPool[ LED_JSON_POOL ];
 
+	//Command being parsed and batch error report, held here rather
+	//than on the task stack
+	char xJsonStr[LED_JSON_LEN + 1];
+	char xErrStr[LED_JSON_LEN];
+
 
 	LEDState *pState = NULL;
 
+	//Last sequence number applied for each command source
+	SeqTracker xSeq;
+
+	//Malformed entries of the current batch
+	BatchErrors xBatchErrors;
+
+	//Batch statistics
+	uint32_t xBatches = 0;
+	uint32_t xBatchCmds = 0;
+	uint32_t xBatchRejected = 0;
+
+	//Apply latency, start is zero when no command is pending
+	uint32_t xApplyStart = 0;
+	uint32_t xApplyUs = 0;
+
 };
 
 
@@ -10,11 +10,20 @@
 #include <string.h>
 #include <stdbool.h>
 #include "json-maker/json-maker.h"
+#include "StateFields.h"
+
+//Fields of the LED state, generates the parser and serialiser
+static constexpr auto xLEDFields = stateFields(
+	stateField("on", ONSLOT, &LEDState::getOn, &LEDState::setOn)
+	);
 
 LEDState::LEDState() {
 	elements=4;
 
-	jsonHelpers[ONSLOT] = (StateFunc)&LEDState::jsonOn;
+	jsonHelpers[ONSLOT] = (StateFunc)&LEDState::jsonCached<ONSLOT>;
+
+	attach(&xCache);
+	attach(&xVersion);
 }
 
 LEDState::~LEDState() {
@@ -27,6 +36,10 @@ LEDState::~LEDState() {
  */
 LEDState::LEDState(const LEDState &other): StateTemp(other) {
 	on = other.getOn();
+	jsonHelpers[ONSLOT] = (StateFunc)&LEDState::jsonCached<ONSLOT>;
+
+	attach(&xCache);
+	attach(&xVersion);
 }
 
 /***
@@ -53,9 +66,48 @@ bool LEDState::getOn() const{
  * @return
  */
 char* LEDState::jsonOn(char *buf, unsigned int len){
-	char *p = buf;
-    p = json_bool( p, "on", getOn(), &len);
-    return p;
+	return xLEDFields.write(this, ONSLOT, buf, len);
+}
+
+/***
+ * Retrieve a slot in JSON format from the cache, rendering it with
+ * the slot's own helper if it has changed. Only slots owned by
+ * LEDState, which always call setDirty when they change, are cached
+ * @param slot
+ * @param buf
+ * @param len
+ * @return
+ */
+char* LEDState::jsonSlot(uint16_t slot, char *buf, unsigned int len){
+	//Read before rendering, so a change on another task while
+	//rendering stops the stale fragment being stored
+	uint32_t gen = xCache.generation(slot);
+
+	char *p = xCache.get(slot, buf, len);
+	if (p == NULL){
+		p = jsonRender(slot, buf, len);
+
+		//json-maker fills the buffer when it truncates, only keep a
+		//fragment that left room to spare
+		if ((unsigned int)(p - buf) + 1 < len){
+			xCache.put(slot, gen, buf, p);
+		}
+	}
+	return p;
+}
+
+/***
+ * Render a cached slot with its own helper
+ * @param slot - ONSLOT or TEMPSLOT
+ * @param buf
+ * @param len
+ * @return
+ */
+char* LEDState::jsonRender(uint16_t slot, char *buf, unsigned int len){
+	if (slot == TEMPSLOT){
+		return jsonSampledTemp(buf, len);
+	}
+	return jsonOn(buf, len);
 }
 
 /***
@@ -65,17 +117,7 @@ char* LEDState::jsonOn(char *buf, unsigned int len){
 void LEDState::updateFromJson(json_t const *json){
 	StateTemp::updateFromJson(json);
 
-	json_t const *jp;
-	uint8_t newRGB[3]={0, 0, 0};
-	bool rgbOK = true;
-
-	jp = json_getProperty(json, "on");
-	if (jp){
-		if (JSON_BOOLEAN == json_getType(jp)){
-			bool b = json_getBoolean(jp);
-			setOn(b);
-		}
-	}
+	xLEDFields.update(this, json);
 }
 
 /***
@@ -85,8 +127,114 @@ void LEDState::updateFromJson(json_t const *json){
  * @return length of json or zero if we ran out of space
  */
 unsigned int LEDState::state(char *buf, unsigned int len){
-	updateTemp();
+	if (pSampler == NULL){
+		updateTemp();
+	}
 	return StateTemp::state(buf, len);
 }
 
+/***
+ * Take temperature from a background sampler rather than reading
+ * the ADC on every serialisation
+ * @param sampler
+ */
+void LEDState::setSampler(TempSampler *sampler){
+	pSampler = sampler;
+	if (pSampler != NULL){
+		pSampler->setObserver(this);
+		xCache.invalidate(TEMPSLOT);
+		jsonHelpers[TEMPSLOT] = (StateFunc)&LEDState::jsonCached<TEMPSLOT>;
+	}
+}
+
+/***
+ * Filtered temperature has moved, mark the slot dirty
+ * @param temp - filtered temperature in Celsius
+ */
+void LEDState::handleTemp(float temp){
+	setDirty(TEMPSLOT);
+}
+
+/***
+ * Retrieve sampled temperature in JSON format
+ * @param buf
+ * @param len
+ * @return
+ */
+char* LEDState::jsonSampledTemp(char *buf, unsigned int len){
+	size_t remLen = len;
+	return json_double(buf, "temp", pSampler->getTemp(), &remLen);
+}
+
+
 
+/***
+ * Number of slot fragments served from the cache
+ * @return
+ */
+uint32_t LEDState::getCacheHits(){
+	return xCache.getHits();
+}
+
+/***
+ * Number of slot fragments that had to be rendered
+ * @return
+ */
+uint32_t LEDState::getCacheMisses(){
+	return xCache.getMisses();
+}
+
+/***
+ * Version of the state, incremented on every change
+ * @return
+ */
+uint32_t LEDState::getVersion(){
+	return xVersion.getVersion();
+}
+
+/***
+ * Retrieve state relative to a version held by the requester.
+ * {"version":n,"notModified":true} if unchanged,
+ * {"version":n,"delta":{...}} with changed slots if version is recent,
+ * {"version":n,"state":{...}} otherwise
+ * @param since - version held by requester, zero for none
+ * @param buf - buffer to write to
+ * @param len - length of buffer
+ * @return length of json or zero if we ran out of space
+ */
+unsigned int LEDState::stateSince(uint32_t since, char *buf, unsigned int len){
+	uint32_t version = xVersion.getVersion();
+	uint16_t dirtyCode;
+	bool full = !xVersion.dirtySince(since, dirtyCode);
+	size_t remLen = len;
+	char *p = buf;
+
+	if (full){
+		if (pSampler == NULL){
+			updateTemp();
+		}
+		dirtyCode = 0xFFFF;
+	}
+
+	p = json_objOpen(p, NULL, &remLen);
+	p = json_uint(p, "version", version, &remLen);
+	if (dirtyCode == 0){
+		p = json_bool(p, "notModified", true, &remLen);
+	} else {
+		p = json_objOpen(p, full ? "state" : "delta", &remLen);
+		for (unsigned char i=0; i < elements; i++){
+			if (((dirtyCode & (1 << i)) != 0) && (jsonHelpers[i] != NULL)){
+				p = (this->*jsonHelpers[i])(p, remLen);
+				remLen = len - (p - buf);
+			}
+		}
+		p = json_objClose(p, &remLen);
+	}
+	p = json_objClose(p, &remLen);
+	p = json_end(p, &remLen);
+
+	if (remLen == 0){
+		return 0;
+	}
+	return p - buf;
+}
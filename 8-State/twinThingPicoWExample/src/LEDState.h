@@ -9,14 +9,23 @@
 #define _LEDSTATE_H_
 
 #include "StateTemp.h"
+#include "StateSlotCache.h"
+#include "StateVersion.h"
+#include "TempSampler.h"
+#include "TempObserver.h"
 #include <stdbool.h>
 #include "pico/stdlib.h"
 
 
 #define ONSLOT  3
 
+//Slot of the temperature within StateTemp
+#ifndef TEMPSLOT
+#define TEMPSLOT 2
+#endif
 
-class LEDState : public StateTemp{
+
+class LEDState : public StateTemp, public TempObserver {
 public:
 	LEDState();
 	LEDState(const LEDState &other);
@@ -47,6 +56,49 @@ public:
 	 */
 	virtual unsigned int state(char *buf, unsigned int len) ;
 
+	/***
+	 * Take temperature from a background sampler rather than reading
+	 * the ADC on every serialisation
+	 * @param sampler
+	 */
+	void setSampler(TempSampler *sampler);
+
+	/***
+	 * Filtered temperature has moved, mark the slot dirty
+	 * @param temp - filtered temperature in Celsius
+	 */
+	virtual void handleTemp(float temp);
+
+	/***
+	 * Version of the state, incremented on every change
+	 * @return
+	 */
+	uint32_t getVersion();
+
+	/***
+	 * Retrieve state relative to a version held by the requester.
+	 * {"version":n,"notModified":true} if unchanged,
+	 * {"version":n,"delta":{...}} with changed slots if version is recent,
+	 * {"version":n,"state":{...}} otherwise
+	 * @param since - version held by requester, zero for none
+	 * @param buf - buffer to write to
+	 * @param len - length of buffer
+	 * @return length of json or zero if we ran out of space
+	 */
+	unsigned int stateSince(uint32_t since, char *buf, unsigned int len);
+
+	/***
+	 * Number of slot fragments served from the cache
+	 * @return
+	 */
+	uint32_t getCacheHits();
+
+	/***
+	 * Number of slot fragments that had to be rendered
+	 * @return
+	 */
+	uint32_t getCacheMisses();
+
 
 protected:
 	/***
@@ -57,11 +109,60 @@ protected:
 	 */
 	char* jsonOn(char *buf, unsigned int len);
 
+	/***
+	 * Retrieve sampled temperature in JSON format
+	 * @param buf
+	 * @param len
+	 * @return
+	 */
+	char* jsonSampledTemp(char *buf, unsigned int len);
+
+	/***
+	 * Retrieve a slot in JSON format from the cache, rendering it with
+	 * the slot's own helper if it has changed. Only slots owned by
+	 * LEDState, which always call setDirty when they change, are cached
+	 * @param slot
+	 * @param buf
+	 * @param len
+	 * @return
+	 */
+	char* jsonSlot(uint16_t slot, char *buf, unsigned int len);
+
+	/***
+	 * Helper installed in jsonHelpers for slot S
+	 * @param buf
+	 * @param len
+	 * @return
+	 */
+	template<uint16_t S>
+	char* jsonCached(char *buf, unsigned int len){
+		return jsonSlot(S, buf, len);
+	}
+
+	/***
+	 * Render a cached slot with its own helper
+	 * @param slot - ONSLOT or TEMPSLOT
+	 * @param buf
+	 * @param len
+	 * @return
+	 */
+	char* jsonRender(uint16_t slot, char *buf, unsigned int len);
+
 private:
 
 	//Is light on
 	bool on = false;
 
+	//Rendered JSON for each slot, attached as an observer of this state
+	StateSlotCache xCache;
+
+
+	//Version tracking, attached as an observer of this state
+	StateVersion xVersion;
+
+	//Background temperature, NULL to read ADC on demand
+	TempSampler *pSampler = NULL;
+
 };
 
 
@@ -7,6 +7,8 @@
 
 #include "MQTTRouterLED.h"
 #include "MQTTTopicHelper.h"
+#include "json-maker/json-maker.h"
+#include "CborJson.h"
 
 #define LED_TOPIC  "LED"
 #define PAYLOAD_ON "on"
@@ -27,6 +29,33 @@ MQTTRouterLED::~MQTTRouterLED() {
  */
 void MQTTRouterLED::subscribe(MQTTInterface *interface){
 	MQTTRouterTwin::subscribe(interface);
+
+	if (pGetTopic == NULL){
+		const char *id = interface->getId();
+		pGetTopic = (char *)pvPortMalloc(MQTTTopicHelper::lenThingGet(id));
+		pUpdTopic = (char *)pvPortMalloc(MQTTTopicHelper::lenThingUpdate(id));
+		pSetTopic = (char *)pvPortMalloc(MQTTTopicHelper::lenThingSet(id));
+		pErrTopic = (char *)pvPortMalloc(
+			MQTTTopicHelper::lenThingTopic(id, MQTT_STATE_ERR_TOPIC));
+		if ((pGetTopic != NULL) && (pUpdTopic != NULL) && (pSetTopic != NULL) &&
+				(pErrTopic != NULL)){
+			MQTTTopicHelper::getThingGet(pGetTopic, id);
+			MQTTTopicHelper::getThingUpdate(pUpdTopic, id);
+			MQTTTopicHelper::getThingSet(pSetTopic, id);
+			MQTTTopicHelper::genThingTopic(pErrTopic, id, MQTT_STATE_ERR_TOPIC);
+
+			pGetCborTopic = cborTopic(pGetTopic);
+			pUpdCborTopic = cborTopic(pUpdTopic);
+			pSetCborTopic = cborTopic(pSetTopic);
+		} else {
+			LogError( ("Unable to allocate topic") );
+		}
+	}
+	if ((pGetCborTopic != NULL) && (pUpdCborTopic != NULL) &&
+			(pSetCborTopic != NULL)){
+		interface->subToTopic(pGetCborTopic, 1);
+		interface->subToTopic(pSetCborTopic, 1);
+	}
 	//Init topic if needed
 	if (pLedTopic == NULL){
 		const char *id = interface->getId();
@@ -39,9 +68,23 @@ void MQTTRouterLED::subscribe(MQTTInterface *interface){
 			LogError( ("Unable to allocate topic") );
 		}
 	}
+	if (pLedCborTopic == NULL){
+		const char *id = interface->getId();
+		pLedCborTopic = (char *)pvPortMalloc(
+			MQTTTopicHelper::lenThingTopic(id, MQTT_LED_REQ_CBOR_TOPIC)
+			);
+		if (pLedCborTopic != NULL){
+			MQTTTopicHelper::genThingTopic(pLedCborTopic, id, MQTT_LED_REQ_CBOR_TOPIC);
+		} else {
+			LogError( ("Unable to allocate topic") );
+		}
+	}
 	if (pLedTopic != NULL){
 		interface->subToTopic(pLedTopic, 1);
 	}
+	if (pLedCborTopic != NULL){
+		interface->subToTopic(pLedCborTopic, 1);
+	}
 }
 
 /***
@@ -58,6 +101,36 @@ void MQTTRouterLED::route(const char *topic,
 		size_t payloadLen,
 		MQTTInterface *interface){
 
+	if ((pGetCborTopic != NULL) && (strlen(pGetCborTopic) == topicLen) &&
+			(memcmp(topic, pGetCborTopic, topicLen) == 0)){
+		cborGet(interface);
+		return;
+	}
+	if ((pSetCborTopic != NULL) && (strlen(pSetCborTopic) == topicLen) &&
+			(memcmp(topic, pSetCborTopic, topicLen) == 0)){
+		cborSet(payload, payloadLen, interface);
+		return;
+	}
+
+	if ((pGetTopic != NULL) && (strlen(pGetTopic) == topicLen) &&
+			(memcmp(topic, pGetTopic, topicLen) == 0)){
+		if (conditionalGet(payload, payloadLen, interface)){
+			return;
+		}
+	}
+
+	if ((pSetTopic != NULL) && (strlen(pSetTopic) == topicLen) &&
+			(memcmp(topic, pSetTopic, topicLen) == 0)){
+		if ((payloadLen > 0) && (((const char *)payload)[0] == '[')){
+			batchSet(topic, topicLen, payload, payloadLen, interface);
+			return;
+		}
+		if (!acceptSet(payload, payloadLen)){
+			LogDebug(("Stale SET dropped"));
+			return;
+		}
+	}
+
 	MQTTRouterTwin::route(topic, topicLen, payload, payloadLen, interface);
 
 	if (strlen(pLedTopic) == topicLen){
@@ -67,4 +140,420 @@ void MQTTRouterLED::route(const char *topic,
 			}
 		}
 	}
+	if ((pLedCborTopic != NULL) && (strlen(pLedCborTopic) == topicLen)){
+		if (memcmp(topic, pLedCborTopic, topicLen)==0){
+			if (pAgent != NULL){
+				pAgent->addCBOR(payload, payloadLen);
+			}
+		}
+	}
+}
+
+/***
+ * Set the state object used to answer conditional GET requests.
+ * A GET carrying "since" or "ifNot" with a version is answered here with
+ * a not modified reply or a delta, any other GET goes to the twin
+ * @param state
+ */
+void MQTTRouterLED::setState(LEDState *state){
+	pState = state;
+}
+
+/***
+ * Number of conditional GETs answered as not modified
+ * @return
+ */
+uint32_t MQTTRouterLED::getNotModified(){
+	return xNotModified;
+}
+
+/***
+ * Number of conditional GETs answered with a delta or full state
+ * @return
+ */
+uint32_t MQTTRouterLED::getConditional(){
+	return xConditional;
+}
+
+/***
+ * Answer a GET that carries a version
+ * @param payload
+ * @param payloadLen
+ * @param interface
+ * @return false if the GET is not conditional and should go to the twin
+ */
+bool MQTTRouterLED::conditionalGet(const void * payload, size_t payloadLen,
+		MQTTInterface *interface){
+	char str[MQTT_GET_LEN + 1];
+	char reply[STATE_MSG_BUF_LEN];
+	json_t const *json;
+	json_t const *jp;
+	unsigned int len;
+
+	if ((pState == NULL) || (pUpdTopic == NULL) || (payloadLen > MQTT_GET_LEN)){
+		return false;
+	}
+	memcpy(str, payload, payloadLen);
+	str[payloadLen] = 0;
+
+	json = json_create(str, pJsonPool, MQTT_JSON_BUF_NUM);
+	if (json == NULL){
+		return false;
+	}
+	jp = json_getProperty(json, "since");
+	if (jp == NULL){
+		jp = json_getProperty(json, "ifNot");
+	}
+	if ((jp == NULL) || (json_getType(jp) != JSON_INTEGER)){
+		return false;
+	}
+
+	uint32_t since = (uint32_t)json_getInteger(jp);
+	if (since == pState->getVersion()){
+		xNotModified++;
+	} else {
+		xConditional++;
+	}
+
+	len = pState->stateSince(since, reply, sizeof(reply));
+	if (len == 0){
+		LogError(("State reply too large"));
+		return true;
+	}
+	interface->pubToTopic(pUpdTopic, reply, len, 1, false);
+	return true;
+}
+
+/***
+ * Allocate the CBOR variant of a topic, the topic with MQTT_CBOR_SUFFIX
+ * @param topic
+ * @return topic or NULL if out of memory
+ */
+char *MQTTRouterLED::cborTopic(const char *topic){
+	size_t len = strlen(topic);
+	char *cbor = (char *)pvPortMalloc(len + sizeof(MQTT_CBOR_SUFFIX));
+	if (cbor == NULL){
+		LogError( ("Unable to allocate topic") );
+		return NULL;
+	}
+	memcpy(cbor, topic, len);
+	memcpy(&cbor[len], MQTT_CBOR_SUFFIX, sizeof(MQTT_CBOR_SUFFIX));
+	return cbor;
+}
+
+/***
+ * Number of twin GET and SET requests received on the CBOR topics
+ * @return
+ */
+uint32_t MQTTRouterLED::getCborReqs(){
+	return xCborReqs;
+}
+
+/***
+ * Answer a GET on the CBOR topic with the full state, every slot,
+ * as a CBOR map on the UPD CBOR topic
+ * @param interface
+ */
+void MQTTRouterLED::cborGet(MQTTInterface *interface){
+	char str[STATE_MSG_BUF_LEN];
+	json_t const *json;
+
+	if (pState == NULL){
+		return;
+	}
+	xCborReqs++;
+
+	if (pState->state(str, sizeof(str)) == 0){
+		LogError(("State too large"));
+		return;
+	}
+	json = json_create(str, pJsonPool, MQTT_JSON_BUF_NUM);
+	if (json == NULL){
+		LogError(("State is not JSON"));
+		return;
+	}
+
+	CborWriter writer(xCbor, sizeof(xCbor));
+	if (!CborJson::fromJson(json, writer)){
+		LogError(("CBOR state reply too large"));
+		return;
+	}
+	interface->pubToTopic(pUpdCborTopic, xCbor, writer.length(), 1, false);
+}
+
+/***
+ * Convert a SET on the CBOR topic to JSON and handle it as a JSON SET,
+ * so it goes through the same seq check and twin update
+ * @param payload
+ * @param payloadLen
+ * @param interface
+ */
+void MQTTRouterLED::cborSet(const void * payload, size_t payloadLen,
+		MQTTInterface *interface){
+	unsigned int len;
+
+	xCborReqs++;
+
+	len = CborJson::toJson((const uint8_t *)payload, payloadLen,
+			xMerged, sizeof(xMerged));
+	if (len == 0){
+		LogError(("Error, CBOR SET is not valid or too large."));
+		return;
+	}
+
+	//batchSet copies the payload before merging into xMerged
+	if (xMerged[0] == '['){
+		batchSet(pSetTopic, strlen(pSetTopic), xMerged, len, interface);
+		return;
+	}
+	if (!acceptSet(xMerged, len)){
+		LogDebug(("Stale SET dropped"));
+		return;
+	}
+	MQTTRouterTwin::route(pSetTopic, strlen(pSetTopic), xMerged, len, interface);
+}
+
+/***
+ * Number of twin SET commands dropped as duplicate or out of order
+ * @return
+ */
+uint32_t MQTTRouterLED::getSetDropped(){
+	return xSetSeq.getDropped();
+}
+
+/***
+ * Check a SET for a stale sequence number
+ * @param payload
+ * @param payloadLen
+ * @return false if SET should be dropped
+ */
+bool MQTTRouterLED::acceptSet(const void * payload, size_t payloadLen){
+	char str[MQTT_SET_LEN + 1];
+	json_t const *json;
+	json_t const *seq;
+	json_t const *src;
+	const char *srcStr = "";
+
+	//Without a readable seq the SET is passed on as before
+	if (payloadLen > MQTT_SET_LEN){
+		return true;
+	}
+	memcpy(str, payload, payloadLen);
+	str[payloadLen] = 0;
+
+	json = json_create(str, pJsonPool, MQTT_JSON_BUF_NUM);
+	if (json == NULL){
+		return true;
+	}
+	seq = json_getProperty(json, "seq");
+	if ((seq == NULL) || (json_getType(seq) != JSON_INTEGER)){
+		return true;
+	}
+	src = json_getProperty(json, "src");
+	if ((src != NULL) && (json_getType(src) == JSON_TEXT)){
+		srcStr = json_getValue(src);
+	}
+	return xSetSeq.accept(srcStr, strlen(srcStr), (uint32_t)json_getInteger(seq));
+}
+
+/***
+ * Number of batched SETs applied
+ * @return
+ */
+uint32_t MQTTRouterLED::getBatches(){
+	return xBatches;
+}
+
+/***
+ * Number of SETs received within batches
+ * @return
+ */
+uint32_t MQTTRouterLED::getBatchCmds(){
+	return xBatchCmds;
+}
+
+/***
+ * Number of batched SETs rejected as malformed
+ * @return
+ */
+uint32_t MQTTRouterLED::getBatchRejected(){
+	return xBatchRejected;
+}
+
+/***
+ * Time taken to check and merge the last batched SET
+ * @return microseconds
+ */
+uint32_t MQTTRouterLED::getBatchUs(){
+	return xBatchUs;
+}
+
+/***
+ * Check an entry of a batched SET
+ * @param entry
+ * @return false if malformed
+ */
+bool MQTTRouterLED::validSetEntry(json_t const *entry){
+	json_t const *state;
+	json_t const *jp;
+
+	if (json_getType(entry) != JSON_OBJ){
+		return false;
+	}
+	state = json_getProperty(entry, "state");
+	if ((state == NULL) || (json_getType(state) != JSON_OBJ)){
+		return false;
+	}
+	for (jp = json_getChild(state); jp != NULL; jp = json_getSibling(jp)){
+		jsonType_t t = json_getType(jp);
+		if ((t == JSON_OBJ) || (t == JSON_ARRAY)){
+			return false;
+		}
+	}
+	jp = json_getProperty(entry, "seq");
+	if ((jp != NULL) && (json_getType(jp) != JSON_INTEGER)){
+		return false;
+	}
+	jp = json_getProperty(entry, "src");
+	if ((jp != NULL) && (json_getType(jp) != JSON_TEXT)){
+		return false;
+	}
+	return true;
+}
+
+/***
+ * Apply a SET holding an array of {"state":{...}} entries as one SET.
+ * Entries are merged in order, so the last value of each property wins,
+ * and passed to the twin to give a single state update. If any entry is
+ * malformed nothing is applied and the bad indexes go to STATE/err
+ * @param topic
+ * @param topicLen
+ * @param payload
+ * @param payloadLen
+ * @param interface
+ */
+void MQTTRouterLED::batchSet(const char *topic, size_t topicLen,
+		const void * payload, size_t payloadLen, MQTTInterface *interface){
+	char str[MQTT_SET_LEN + 1];
+	json_t const *fields[MQTT_BATCH_FIELDS];
+	uint8_t numFields = 0;
+	json_t const *json;
+	json_t const *entry;
+	json_t const *jp;
+	uint16_t index = 0;
+	uint32_t start = time_us_32();
+
+	if (payloadLen > MQTT_SET_LEN){
+		LogError(("Batched SET too large %d", payloadLen));
+		return;
+	}
+	memcpy(str, payload, payloadLen);
+	str[payloadLen] = 0;
+
+	json = json_create(str, pJsonPool, MQTT_JSON_BUF_NUM);
+	if ((json == NULL) || (json_getType(json) != JSON_ARRAY)){
+		LogError(("Batched SET is not a JSON array"));
+		return;
+	}
+
+	//Check every entry before applying any
+	xBatchErrors.clear();
+	for (entry = json_getChild(json); entry != NULL; entry = json_getSibling(entry)){
+		if (!validSetEntry(entry)){
+			LogError(("SET batch entry %d malformed", index));
+			xBatchErrors.add(index);
+		}
+		index++;
+	}
+	xBatchCmds += index;
+
+	if (xBatchErrors.count() > 0){
+		xBatchRejected++;
+		if (pErrTopic != NULL){
+			char reply[MQTT_GET_LEN * 2];
+			unsigned int len = xBatchErrors.json(reply, sizeof(reply));
+			if (len > 0){
+				interface->pubToTopic(pErrTopic, reply, len, 1, false);
+			}
+		}
+		return;
+	}
+
+	//Sequence numbers are checked on a copy and only kept once the
+	//merged SET has been built, so a failed batch can be resent
+	SeqTracker seq = xSetSeq;
+
+	//Merge fresh entries, later values replace earlier ones
+	for (entry = json_getChild(json); entry != NULL; entry = json_getSibling(entry)){
+		jp = json_getProperty(entry, "seq");
+		if (jp != NULL){
+			json_t const *src = json_getProperty(entry, "src");
+			const char *srcStr = "";
+			if (src != NULL){
+				srcStr = json_getValue(src);
+			}
+			if (!seq.accept(srcStr, strlen(srcStr), (uint32_t)json_getInteger(jp))){
+				continue;
+			}
+		}
+		jp = json_getChild(json_getProperty(entry, "state"));
+		for (; jp != NULL; jp = json_getSibling(jp)){
+			uint8_t i;
+			for (i=0; i < numFields; i++){
+				if (strcmp(json_getName(fields[i]), json_getName(jp)) == 0){
+					break;
+				}
+			}
+			if (i < MQTT_BATCH_FIELDS){
+				fields[i] = jp;
+				if (i == numFields){
+					numFields++;
+				}
+			} else {
+				LogWarn(("Too many properties in batched SET"));
+			}
+		}
+	}
+	if (numFields == 0){
+		LogDebug(("Stale SET batch dropped"));
+		return;
+	}
+
+	//Write the merged SET
+	size_t remLen = sizeof(xMerged);
+	char *p = xMerged;
+	p = json_objOpen(p, NULL, &remLen);
+	p = json_objOpen(p, "state", &remLen);
+	for (uint8_t i=0; i < numFields; i++){
+		const char *name = json_getName(fields[i]);
+		switch(json_getType(fields[i])){
+			case JSON_BOOLEAN:
+				p = json_bool(p, name, json_getBoolean(fields[i]), &remLen);
+				break;
+			case JSON_INTEGER:
+				p = json_long(p, name, (long)json_getInteger(fields[i]), &remLen);
+				break;
+			case JSON_REAL:
+				p = json_double(p, name, json_getReal(fields[i]), &remLen);
+				break;
+			case JSON_TEXT:
+				p = json_str(p, name, json_getValue(fields[i]), &remLen);
+				break;
+			default:
+				p = json_null(p, name, &remLen);
+				break;
+		}
+	}
+	p = json_objClose(p, &remLen);
+	p = json_objClose(p, &remLen);
+	p = json_end(p, &remLen);
+	if (remLen == 0){
+		LogError(("Merged SET too large"));
+		return;
+	}
+
+	xSetSeq = seq;
+	xBatches++;
+	xBatchUs = time_us_32() - start;
+	MQTTRouterTwin::route(topic, topicLen, xMerged, p - xMerged, interface);
 }
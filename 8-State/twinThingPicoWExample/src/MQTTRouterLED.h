@@ -14,8 +14,35 @@
 
 #include "tiny-json.h"
 #include "LEDAgent.h"
+#include "SeqTracker.h"
+#include "BatchErrors.h"
 
 #define MQTT_LED_REQ_TOPIC 	"LED/req"
+#define MQTT_LED_REQ_CBOR_TOPIC 	"LED/req/cbor"
+#define MQTT_STATE_ERR_TOPIC 	"STATE/err"
+
+//Suffix of the twin GET, SET and UPD topics that carry CBOR
+#define MQTT_CBOR_SUFFIX 	"/cbor"
+
+//Longest CBOR state reply, never longer than the JSON it is made from
+#ifndef MQTT_CBOR_LEN
+#define MQTT_CBOR_LEN 	STATE_MAX_MSG_LEN
+#endif
+
+//Longest conditional GET payload, e.g. {"since":12345}
+#ifndef MQTT_GET_LEN
+#define MQTT_GET_LEN 	40
+#endif
+
+//Longest SET payload checked for a sequence number
+#ifndef MQTT_SET_LEN
+#define MQTT_SET_LEN 	STATE_MAX_MSG_LEN
+#endif
+
+//Distinct state properties merged from a batched SET
+#ifndef MQTT_BATCH_FIELDS
+#define MQTT_BATCH_FIELDS 	8
+#endif
 
 class MQTTRouterLED : public MQTTRouterTwin{
 public:
@@ -42,11 +69,161 @@ public:
 	virtual void route(const char *topic, size_t topicLen, const void * payload,
 			size_t payloadLen, MQTTInterface *interface);
 
+	/***
+	 * Set the state object used to answer conditional GET requests.
+	 * A GET carrying "since" or "ifNot" with a version is answered here with
+	 * a not modified reply or a delta, any other GET goes to the twin
+	 * @param state
+	 */
+	void setState(LEDState *state);
+
+	/***
+	 * Number of twin GET and SET requests received on the CBOR topics
+	 * @return
+	 */
+	uint32_t getCborReqs();
+
+	/***
+	 * Number of twin SET commands dropped as duplicate or out of order
+	 * @return
+	 */
+	uint32_t getSetDropped();
+
+	/***
+	 * Number of conditional GETs answered as not modified
+	 * @return
+	 */
+	uint32_t getNotModified();
+
+	/***
+	 * Number of conditional GETs answered with a delta or full state
+	 * @return
+	 */
+	uint32_t getConditional();
+
+	/***
+	 * Number of batched SETs applied
+	 * @return
+	 */
+	uint32_t getBatches();
+
+	/***
+	 * Number of SETs received within batches
+	 * @return
+	 */
+	uint32_t getBatchCmds();
+
+	/***
+	 * Number of batched SETs rejected as malformed
+	 * @return
+	 */
+	uint32_t getBatchRejected();
+
+	/***
+	 * Time taken to check and merge the last batched SET
+	 * @return microseconds
+	 */
+	uint32_t getBatchUs();
 
 
 private:
 	LEDAgent *pAgent = NULL;
 	char *pLedTopic = NULL;
+	char *pLedCborTopic = NULL;
+	char *pGetTopic = NULL;
+	char *pUpdTopic = NULL;
+	char *pSetTopic = NULL;
+	char *pErrTopic = NULL;
+	char *pGetCborTopic = NULL;
+	char *pUpdCborTopic = NULL;
+	char *pSetCborTopic = NULL;
+
+	LEDState *pState = NULL;
+	json_t pJsonPool[ MQTT_JSON_BUF_NUM ];
+
+	//Last sequence number applied for each SET source
+	SeqTracker xSetSeq;
+
+	uint32_t xNotModified = 0;
+	uint32_t xConditional = 0;
+	uint32_t xCborReqs = 0;
+
+	//CBOR state reply
+	uint8_t xCbor[MQTT_CBOR_LEN];
+
+	//Malformed entries of the current batch
+	BatchErrors xBatchErrors;
+
+	//Batched SET merged into a single SET for the twin
+	char xMerged[MQTT_SET_LEN + 1];
+
+	uint32_t xBatches = 0;
+	uint32_t xBatchCmds = 0;
+	uint32_t xBatchRejected = 0;
+	uint32_t xBatchUs = 0;
+
+	/***
+	 * Answer a GET that carries a version
+	 * @param payload
+	 * @param payloadLen
+	 * @param interface
+	 * @return false if the GET is not conditional and should go to the twin
+	 */
+	bool conditionalGet(const void * payload, size_t payloadLen,
+			MQTTInterface *interface);
+
+	/***
+	 * Allocate the CBOR variant of a topic, the topic with MQTT_CBOR_SUFFIX
+	 * @param topic
+	 * @return topic or NULL if out of memory
+	 */
+	static char *cborTopic(const char *topic);
+
+	/***
+	 * Answer a GET on the CBOR topic with the full state, every slot,
+	 * as a CBOR map on the UPD CBOR topic
+	 * @param interface
+	 */
+	void cborGet(MQTTInterface *interface);
+
+	/***
+	 * Convert a SET on the CBOR topic to JSON and handle it as a JSON SET,
+	 * so it goes through the same seq check and twin update
+	 * @param payload
+	 * @param payloadLen
+	 * @param interface
+	 */
+	void cborSet(const void * payload, size_t payloadLen,
+			MQTTInterface *interface);
+
+	/***
+	 * Check a SET for a stale sequence number
+	 * @param payload
+	 * @param payloadLen
+	 * @return false if SET should be dropped
+	 */
+	bool acceptSet(const void * payload, size_t payloadLen);
+
+	/***
+	 * Apply a SET holding an array of {"state":{...}} entries as one SET.
+	 * Entries are merged in order, so the last value of each property wins,
+	 * and passed to the twin to give a single state update. If any entry is
+	 * malformed nothing is applied and the bad indexes go to STATE/err
+	 * @param topic
+	 * @param topicLen
+	 * @param payload
+	 * @param payloadLen
+	 * @param interface
+	 */
+	void batchSet(const char *topic, size_t topicLen, const void * payload,
+			size_t payloadLen, MQTTInterface *interface);
+
+	/***
+	 * Check an entry of a batched SET
+	 * @param entry
+	 * @return false if malformed
+	 */
+	bool validSetEntry(json_t const *entry);
 
 };
 
@@ -0,0 +1,88 @@
+/*
+ * SeqTracker.cpp
+ *
+ * Tracks the last command sequence number applied for each source so
+ * duplicate and out of order commands can be dropped before they are
+ * acted on. Sequence numbers may wrap.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "SeqTracker.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/***
+ * Constructor
+ */
+SeqTracker::SeqTracker() {
+	for (uint8_t i=0; i < SEQ_SOURCES; i++){
+		xSources[i].valid = false;
+		xSources[i].used = 0;
+	}
+}
+
+/***
+ * Destructor
+ */
+SeqTracker::~SeqTracker() {
+	// NOP
+}
+
+/***
+ * Check a command's sequence number and record it if accepted
+ * @param src - source of the command, need not be terminated
+ * @param srcLen - length of source, zero for the default source
+ * @param seq - sequence number
+ * @return false if the command is a duplicate or older than one applied
+ */
+bool SeqTracker::accept(const char *src, size_t srcLen, uint32_t seq){
+	uint32_t hash = 2166136261U;
+	uint8_t slot = 0;
+	bool res = true;
+
+	for (size_t i=0; i < srcLen; i++){
+		hash ^= (uint8_t)src[i];
+		hash *= 16777619U;
+	}
+
+	taskENTER_CRITICAL();
+	xUse++;
+	for (uint8_t i=0; i < SEQ_SOURCES; i++){
+		if (xSources[i].valid && (xSources[i].hash == hash)){
+			slot = i;
+			break;
+		}
+		//Otherwise remember the least recently used
+		if (xSources[i].used < xSources[slot].used){
+			slot = i;
+		}
+	}
+
+	if (xSources[slot].valid && (xSources[slot].hash == hash)){
+		//Serial number compare so a wrapped sequence is still newer
+		if ((int32_t)(seq - xSources[slot].seq) <= 0){
+			res = false;
+			xDropped++;
+		}
+	} else {
+		xSources[slot].valid = true;
+		xSources[slot].hash = hash;
+	}
+	if (res){
+		xSources[slot].seq = seq;
+	}
+	xSources[slot].used = xUse;
+	taskEXIT_CRITICAL();
+
+	return res;
+}
+
+/***
+ * Number of commands rejected
+ * @return
+ */
+uint32_t SeqTracker::getDropped(){
+	return xDropped;
+}
@@ -0,0 +1,63 @@
+/*
+ * SeqTracker.h
+ *
+ * Tracks the last command sequence number applied for each source so
+ * duplicate and out of order commands can be dropped before they are
+ * acted on. Sequence numbers may wrap.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _SEQTRACKER_H_
+#define _SEQTRACKER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//Number of sources tracked, least recently seen is replaced
+#ifndef SEQ_SOURCES
+#define SEQ_SOURCES 	4
+#endif
+
+class SeqTracker {
+public:
+	/***
+	 * Constructor
+	 */
+	SeqTracker();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~SeqTracker();
+
+	/***
+	 * Check a command's sequence number and record it if accepted
+	 * @param src - source of the command, need not be terminated
+	 * @param srcLen - length of source, zero for the default source
+	 * @param seq - sequence number
+	 * @return false if the command is a duplicate or older than one applied
+	 */
+	bool accept(const char *src, size_t srcLen, uint32_t seq);
+
+	/***
+	 * Number of commands rejected
+	 * @return
+	 */
+	uint32_t getDropped();
+
+private:
+	struct SeqSource {
+		uint32_t hash;
+		uint32_t seq;
+		uint32_t used;
+		bool valid;
+	};
+
+	SeqSource xSources[SEQ_SOURCES];
+	uint32_t xUse = 0;
+	volatile uint32_t xDropped = 0;
+};
+
+#endif /* _SEQTRACKER_H_ */
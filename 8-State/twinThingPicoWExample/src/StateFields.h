@@ -0,0 +1,414 @@
+/*
+ * StateFields.h
+ *
+ * Compile time description of the fields of a twin State class.
+ * From a list of name, slot, getter and setter it generates a single
+ * pass JSON parser and a per slot JSON serialiser, plus the CBOR
+ * equivalents. The parser finds each property's field by a binary
+ * search of the name hashes, sorted at compile time, then calls that
+ * field's setter through a table.
+ *
+ * Example:
+ *   static constexpr auto xFields = stateFields(
+ *       stateField("on", ONSLOT, &LEDState::getOn, &LEDState::setOn));
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _STATEFIELDS_H_
+#define _STATEFIELDS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
+#include <array>
+#include <utility>
+#include "tiny-json.h"
+#include "json-maker/json-maker.h"
+#include "CborWriter.h"
+#include "CborReader.h"
+
+/***
+ * FNV-1a hash of a field name, the key the fields are sorted by
+ * @param name - zero terminated name
+ * @return hash
+ */
+constexpr uint32_t stateFieldHash(const char *name){
+	uint32_t hash = 2166136261U;
+	while (*name != 0){
+		hash ^= (uint8_t)*name;
+		hash *= 16777619U;
+		name++;
+	}
+	return hash;
+}
+
+/***
+ * FNV-1a hash of a name that is not terminated, such as a CBOR key
+ * @param name - name
+ * @param len - length of name
+ * @return hash
+ */
+constexpr uint32_t stateFieldHash(const char *name, size_t len){
+	uint32_t hash = 2166136261U;
+	for (size_t i=0; i < len; i++){
+		hash ^= (uint8_t)name[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/***
+ * Read a value of the field's type from a JSON property
+ * @param jp - property
+ * @param v - value to set
+ * @return false if property is not of a compatible type
+ */
+inline bool stateFieldRead(json_t const *jp, bool &v){
+	if (json_getType(jp) != JSON_BOOLEAN){
+		return false;
+	}
+	v = json_getBoolean(jp);
+	return true;
+}
+
+inline bool stateFieldRead(json_t const *jp, int &v){
+	if (json_getType(jp) != JSON_INTEGER){
+		return false;
+	}
+	v = (int)json_getInteger(jp);
+	return true;
+}
+
+inline bool stateFieldRead(json_t const *jp, double &v){
+	jsonType_t t = json_getType(jp);
+	if ((t != JSON_REAL) && (t != JSON_INTEGER)){
+		return false;
+	}
+	v = json_getReal(jp);
+	return true;
+}
+
+inline bool stateFieldRead(json_t const *jp, const char * &v){
+	if (json_getType(jp) != JSON_TEXT){
+		return false;
+	}
+	v = json_getValue(jp);
+	return true;
+}
+
+/***
+ * Write a field value as a named JSON property
+ * @param p - position to write to
+ * @param name - property name
+ * @param v - value
+ * @param remLen - remaining length of buffer, updated
+ * @return next write position
+ */
+inline char* stateFieldWrite(char *p, const char *name, bool v, size_t *remLen){
+	return json_bool(p, name, v, remLen);
+}
+
+inline char* stateFieldWrite(char *p, const char *name, int v, size_t *remLen){
+	return json_int(p, name, v, remLen);
+}
+
+inline char* stateFieldWrite(char *p, const char *name, double v, size_t *remLen){
+	return json_double(p, name, v, remLen);
+}
+
+inline char* stateFieldWrite(char *p, const char *name, const char *v, size_t *remLen){
+	return json_str(p, name, v, remLen);
+}
+
+/***
+ * Read a value of the field's type from CBOR
+ * @param r - reader positioned at the value
+ * @param v - value to set
+ * @return false if value is not of a compatible type
+ */
+inline bool stateFieldRead(CborReader &r, bool &v){
+	return r.boolean(v);
+}
+
+inline bool stateFieldRead(CborReader &r, int &v){
+	int64_t i;
+	if (!r.integer(i)){
+		return false;
+	}
+	v = (int)i;
+	return true;
+}
+
+inline bool stateFieldRead(CborReader &r, double &v){
+	return r.real(v);
+}
+
+inline bool stateFieldRead(CborReader &r, const char * &v){
+	//CBOR text is not terminated so can't be handed to a setter in place
+	return false;
+}
+
+/***
+ * Write a field value to CBOR
+ * @param w - writer
+ * @param v - value
+ * @return false if out of space
+ */
+inline bool stateFieldWrite(CborWriter &w, bool v){
+	return w.boolean(v);
+}
+
+inline bool stateFieldWrite(CborWriter &w, int v){
+	return w.integer(v);
+}
+
+inline bool stateFieldWrite(CborWriter &w, double v){
+	return w.real(v);
+}
+
+inline bool stateFieldWrite(CborWriter &w, const char *v){
+	return w.text(v);
+}
+
+/***
+ * Description of one field: JSON name, state slot, getter and setter
+ */
+template<class C, class V>
+struct StateField {
+	const char *name;
+	uint16_t slot;
+	V (C::*get)() const;
+	void (C::*set)(V);
+	uint32_t hash;
+
+	constexpr StateField(const char *n, uint16_t s,
+			V (C::*g)() const, void (C::*st)(V)) :
+		name(n), slot(s), get(g), set(st), hash(stateFieldHash(n)) {}
+};
+
+/***
+ * Build a field description, deducing the class and value type
+ * @param name - JSON name
+ * @param slot - state slot, as used by setDirty
+ * @param get - getter
+ * @param set - setter
+ * @return field description
+ */
+template<class C, class V>
+constexpr StateField<C, V> stateField(const char *name, uint16_t slot,
+		V (C::*get)() const, void (C::*set)(V)){
+	return StateField<C, V>(name, slot, get, set);
+}
+
+
+/***
+ * Set of fields for a state class
+ */
+template<class C, class... V>
+class StateFieldSet {
+public:
+	constexpr StateFieldSet(StateField<C, V>... fields) :
+			xFields(fields...),
+			xUpdaters(updaters(std::index_sequence_for<V...>{})),
+			xCborUpdaters(cborUpdaters(std::index_sequence_for<V...>{})) {
+		const char *names[] = {fields.name..., NULL};
+		const uint32_t hashes[] = {fields.hash..., 0};
+		for (size_t i=0; i < sizeof...(V); i++){
+			xHashes[i] = hashes[i];
+			xNames[i] = names[i];
+			xIndex[i] = (uint8_t)i;
+		}
+		//Insertion sort by hash, done once by the compiler
+		for (size_t i=1; i < sizeof...(V); i++){
+			for (size_t j=i; (j > 0) && (xHashes[j-1] > xHashes[j]); j--){
+				uint32_t h = xHashes[j];
+				xHashes[j] = xHashes[j-1];
+				xHashes[j-1] = h;
+				const char *n = xNames[j];
+				xNames[j] = xNames[j-1];
+				xNames[j-1] = n;
+				uint8_t x = xIndex[j];
+				xIndex[j] = xIndex[j-1];
+				xIndex[j-1] = x;
+			}
+		}
+	}
+
+	/***
+	 * Update the object from a JSON object in one pass over its properties.
+	 * Unknown properties and those of the wrong type are ignored
+	 * @param obj - object to update
+	 * @param json - parsed JSON object
+	 */
+	void update(C *obj, json_t const *json) const {
+		for (json_t const *jp = json_getChild(json); jp != NULL;
+				jp = json_getSibling(jp)){
+			const char *name = json_getName(jp);
+			if (name == NULL){
+				continue;
+			}
+			int i = find(name, strlen(name));
+			if (i >= 0){
+				(this->*xUpdaters[i])(obj, jp);
+			}
+		}
+	}
+
+	/***
+	 * Write the field for a slot as a JSON property
+	 * @param obj - object to read
+	 * @param slot - state slot
+	 * @param buf - buffer to write to
+	 * @param len - length of buffer
+	 * @return next write position, buf if slot is not a field
+	 */
+	char* write(const C *obj, uint16_t slot, char *buf, unsigned int len) const {
+		size_t remLen = len;
+		char *p = buf;
+		std::apply([&](auto const &... f){
+			((f.slot == slot ?
+				(p = stateFieldWrite(p, f.name, (obj->*f.get)(), &remLen), true) :
+				false) || ...);
+		}, xFields);
+		return p;
+	}
+
+	/***
+	 * Update the object from a CBOR map in one pass over its pairs.
+	 * Unknown keys and values of the wrong type are skipped. Text values
+	 * are not supported as CBOR strings are not terminated
+	 * @param obj - object to update
+	 * @param r - reader positioned at the map
+	 * @return false if the CBOR is malformed
+	 */
+	bool updateCbor(C *obj, CborReader &r) const {
+		size_t count;
+		if (!r.map(count)){
+			return false;
+		}
+		for (size_t i=0; i < count; i++){
+			const char *key;
+			size_t keyLen;
+			if (!r.text(key, keyLen)){
+				return false;
+			}
+			int f = find(key, keyLen);
+			if (f >= 0){
+				(this->*xCborUpdaters[f])(obj, r);
+			} else if (!r.skip()){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/***
+	 * Write all fields as a CBOR map
+	 * @param obj - object to read
+	 * @param w - writer
+	 * @return false if out of space
+	 */
+	bool writeCbor(const C *obj, CborWriter &w) const {
+		w.map(sizeof...(V));
+		std::apply([&](auto const &... f){
+			((w.text(f.name) && stateFieldWrite(w, (obj->*f.get)())), ...);
+		}, xFields);
+		return w.ok();
+	}
+
+	/***
+	 * Number of fields
+	 * @return
+	 */
+	static constexpr size_t size(){
+		return sizeof...(V);
+	}
+
+private:
+	typedef void (StateFieldSet::*Updater)(C *obj, json_t const *jp) const;
+	typedef void (StateFieldSet::*CborUpdater)(C *obj, CborReader &r) const;
+
+	/***
+	 * Find a field by name
+	 * @param name - name, need not be terminated
+	 * @param len - length of name
+	 * @return index of the field in xFields, -1 if not a field
+	 */
+	int find(const char *name, size_t len) const {
+		uint32_t hash = stateFieldHash(name, len);
+		size_t lo = 0;
+		size_t hi = sizeof...(V);
+		while (lo < hi){
+			size_t mid = (lo + hi) / 2;
+			if (xHashes[mid] < hash){
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		//Names that share a hash sit together
+		for (; (lo < sizeof...(V)) && (xHashes[lo] == hash); lo++){
+			if ((strncmp(xNames[lo], name, len) == 0) && (xNames[lo][len] == 0)){
+				return xIndex[lo];
+			}
+		}
+		return -1;
+	}
+
+	template<size_t I>
+	void updateAt(C *obj, json_t const *jp) const {
+		auto const &f = std::get<I>(xFields);
+		std::tuple_element_t<I, std::tuple<V...>> v;
+		if (stateFieldRead(jp, v)){
+			(obj->*f.set)(v);
+		}
+	}
+
+	template<size_t I>
+	void updateCborAt(C *obj, CborReader &r) const {
+		auto const &f = std::get<I>(xFields);
+		std::tuple_element_t<I, std::tuple<V...>> v;
+		if (stateFieldRead(r, v)){
+			(obj->*f.set)(v);
+		} else {
+			r.skip();
+		}
+	}
+
+	template<size_t... I>
+	static constexpr std::array<Updater, sizeof...(V)> updaters(
+			std::index_sequence<I...>){
+		return {{ &StateFieldSet::updateAt<I>... }};
+	}
+
+	template<size_t... I>
+	static constexpr std::array<CborUpdater, sizeof...(V)> cborUpdaters(
+			std::index_sequence<I...>){
+		return {{ &StateFieldSet::updateCborAt<I>... }};
+	}
+
+	std::tuple<StateField<C, V>...> xFields;
+
+	//Setter of each field, by index in xFields
+	std::array<Updater, sizeof...(V)> xUpdaters;
+	std::array<CborUpdater, sizeof...(V)> xCborUpdaters;
+
+	//Field hashes in ascending order, with the name and index of each
+	std::array<uint32_t, sizeof...(V)> xHashes{};
+	std::array<const char *, sizeof...(V)> xNames{};
+	std::array<uint8_t, sizeof...(V)> xIndex{};
+};
+
+/***
+ * Build a field set, deducing the types
+ * @param fields - field descriptions from stateField
+ * @return field set
+ */
+template<class C, class... V>
+constexpr StateFieldSet<C, V...> stateFields(StateField<C, V>... fields){
+	return StateFieldSet<C, V...>(fields...);
+}
+
+#endif /* _STATEFIELDS_H_ */
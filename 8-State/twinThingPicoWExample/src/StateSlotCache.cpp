@@ -0,0 +1,149 @@
+/*
+ * StateSlotCache.cpp
+ *
+ * Cache of the serialised JSON fragment for each slot of a State object.
+ * Attached as an observer of the State, each change notified invalidates
+ * the dirty slots. A slot is only rendered again once it has been
+ * invalidated, so a GET or UPD after a single change re-renders just that
+ * slot. Each slot has a generation, moved on by every invalidate, so a
+ * fragment rendered while its slot changed is not stored.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "StateSlotCache.h"
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/***
+ * Constructor - all slots start invalid
+ */
+StateSlotCache::StateSlotCache() {
+	for (uint16_t i=0; i < STATE_CACHE_SLOTS; i++){
+		xGens[i] = 0;
+		xLens[i] = 0;
+	}
+}
+
+/***
+ * Destructor
+ */
+StateSlotCache::~StateSlotCache() {
+	// NOP
+}
+
+/***
+ * Mark a slot as needing to be rendered again
+ * @param slot
+ */
+void StateSlotCache::invalidate(uint16_t slot){
+	if (slot < STATE_CACHE_SLOTS){
+		notifyState(1 << slot);
+	}
+}
+
+/***
+ * Mark all slots as needing to be rendered again
+ */
+void StateSlotCache::invalidateAll(){
+	notifyState(0xFFFF);
+}
+
+/***
+ * Notification of a change of a state item with the State object.
+ * Invalidates the slots changed
+ * @param dirtyCode - Representation of item changed within state
+ */
+void StateSlotCache::notifyState(uint16_t dirtyCode){
+	taskENTER_CRITICAL();
+	for (uint16_t i=0; i < STATE_CACHE_SLOTS; i++){
+		if ((dirtyCode & (1 << i)) != 0){
+			xGens[i]++;
+		}
+	}
+	xValid &= ~(uint32_t)dirtyCode;
+	taskEXIT_CRITICAL();
+}
+
+/***
+ * Copy the cached fragment for a slot into the buffer
+ * @param slot
+ * @param buf - buffer to write to
+ * @param len - length of buffer
+ * @return position after the fragment, or NULL if not cached or no room
+ */
+char* StateSlotCache::get(uint16_t slot, char *buf, unsigned int len){
+	char *p = NULL;
+
+	if (slot >= STATE_CACHE_SLOTS){
+		return NULL;
+	}
+	taskENTER_CRITICAL();
+	//Leave room for the terminator json-maker would have written
+	if (((xValid & (1UL << slot)) != 0) && (xLens[slot] < len)){
+		memcpy(buf, xFrags[slot], xLens[slot]);
+		buf[xLens[slot]] = 0;
+		p = buf + xLens[slot];
+		xHits++;
+	} else {
+		xMisses++;
+	}
+	taskEXIT_CRITICAL();
+	return p;
+}
+
+/***
+ * Generation of a slot, to be read before rendering it
+ * @param slot
+ * @return generation
+ */
+uint32_t StateSlotCache::generation(uint16_t slot){
+	uint32_t gen = 0;
+	if (slot < STATE_CACHE_SLOTS){
+		taskENTER_CRITICAL();
+		gen = xGens[slot];
+		taskEXIT_CRITICAL();
+	}
+	return gen;
+}
+
+/***
+ * Store the fragment just rendered for a slot. Fragments too large for
+ * the cache, or for a slot invalidated since gen was read, are not stored
+ * @param slot
+ * @param gen - generation of the slot read before rendering
+ * @param start - start of the rendered fragment
+ * @param end - position after the fragment
+ */
+void StateSlotCache::put(uint16_t slot, uint32_t gen, const char *start,
+		const char *end){
+	size_t len = end - start;
+	if ((slot >= STATE_CACHE_SLOTS) || (len > STATE_CACHE_FRAG_LEN)){
+		return;
+	}
+	taskENTER_CRITICAL();
+	if (xGens[slot] == gen){
+		memcpy(xFrags[slot], start, len);
+		xLens[slot] = len;
+		xValid |= (1UL << slot);
+	}
+	taskEXIT_CRITICAL();
+}
+
+/***
+ * Number of fragments served from the cache
+ * @return
+ */
+uint32_t StateSlotCache::getHits(){
+	return xHits;
+}
+
+/***
+ * Number of fragments that had to be rendered
+ * @return
+ */
+uint32_t StateSlotCache::getMisses(){
+	return xMisses;
+}
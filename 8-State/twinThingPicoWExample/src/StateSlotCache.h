@@ -0,0 +1,108 @@
+/*
+ * StateSlotCache.h
+ *
+ * Cache of the serialised JSON fragment for each slot of a State object.
+ * Attached as an observer of the State, each change notified invalidates
+ * the dirty slots. A slot is only rendered again once it has been
+ * invalidated, so a GET or UPD after a single change re-renders just that
+ * slot. Each slot has a generation, moved on by every invalidate, so a
+ * fragment rendered while its slot changed is not stored.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _STATESLOTCACHE_H_
+#define _STATESLOTCACHE_H_
+
+#include "StateObserver.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef STATE_CACHE_SLOTS
+#define STATE_CACHE_SLOTS 		8
+#endif
+
+#ifndef STATE_CACHE_FRAG_LEN
+#define STATE_CACHE_FRAG_LEN 	40
+#endif
+
+class StateSlotCache : public StateObserver {
+public:
+	/***
+	 * Constructor - all slots start invalid
+	 */
+	StateSlotCache();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~StateSlotCache();
+
+	/***
+	 * Mark a slot as needing to be rendered again
+	 * @param slot
+	 */
+	void invalidate(uint16_t slot);
+
+	/***
+	 * Mark all slots as needing to be rendered again
+	 */
+	void invalidateAll();
+
+	/***
+	 * Notification of a change of a state item with the State object.
+	 * Invalidates the slots changed
+	 * @param dirtyCode - Representation of item changed within state
+	 */
+	virtual void notifyState(uint16_t dirtyCode);
+
+	/***
+	 * Copy the cached fragment for a slot into the buffer
+	 * @param slot
+	 * @param buf - buffer to write to
+	 * @param len - length of buffer
+	 * @return position after the fragment, or NULL if not cached or no room
+	 */
+	char* get(uint16_t slot, char *buf, unsigned int len);
+
+	/***
+	 * Generation of a slot, to be read before rendering it
+	 * @param slot
+	 * @return generation
+	 */
+	uint32_t generation(uint16_t slot);
+
+	/***
+	 * Store the fragment just rendered for a slot. Fragments too large for
+	 * the cache, or for a slot invalidated since gen was read, are not stored
+	 * @param slot
+	 * @param gen - generation of the slot read before rendering
+	 * @param start - start of the rendered fragment
+	 * @param end - position after the fragment
+	 */
+	void put(uint16_t slot, uint32_t gen, const char *start, const char *end);
+
+	/***
+	 * Number of fragments served from the cache
+	 * @return
+	 */
+	uint32_t getHits();
+
+	/***
+	 * Number of fragments that had to be rendered
+	 * @return
+	 */
+	uint32_t getMisses();
+
+private:
+	char xFrags[STATE_CACHE_SLOTS][STATE_CACHE_FRAG_LEN];
+	uint8_t xLens[STATE_CACHE_SLOTS];
+	uint32_t xValid = 0;
+	uint32_t xGens[STATE_CACHE_SLOTS];
+
+	uint32_t xHits = 0;
+	uint32_t xMisses = 0;
+};
+
+#endif /* _STATESLOTCACHE_H_ */
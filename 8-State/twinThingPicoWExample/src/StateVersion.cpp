@@ -0,0 +1,74 @@
+/*
+ * StateVersion.cpp
+ *
+ * Tracks a version number for a State object. Each change notified by the
+ * State increments the version, and the slots changed by recent versions
+ * are kept so a delta since a given version can be produced.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "StateVersion.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/***
+ * Constructor
+ */
+StateVersion::StateVersion() {
+	for (uint8_t i=0; i < STATE_VERSION_HISTORY; i++){
+		xHistory[i] = 0;
+	}
+}
+
+/***
+ * Destructor
+ */
+StateVersion::~StateVersion() {
+	// NOP
+}
+
+/***
+ * Notification of a change of a state item with the State object.
+ * Increments the version
+ * @param dirtyCode - Representation of item changed within state
+ */
+void StateVersion::notifyState(uint16_t dirtyCode){
+	taskENTER_CRITICAL();
+	xVersion++;
+	xHistory[xVersion % STATE_VERSION_HISTORY] = dirtyCode;
+	taskEXIT_CRITICAL();
+}
+
+/***
+ * Current version
+ * @return
+ */
+uint32_t StateVersion::getVersion(){
+	return xVersion;
+}
+
+/***
+ * Slots changed since a version
+ * @param since - version the requester holds
+ * @param dirtyCode - set to slots changed after that version
+ * @return false if the version is too old or unknown, full state needed
+ */
+bool StateVersion::dirtySince(uint32_t since, uint16_t &dirtyCode){
+	bool res = true;
+
+	dirtyCode = 0;
+	taskENTER_CRITICAL();
+	//Version zero means the requester holds nothing
+	if ((since == 0) || (since > xVersion) ||
+			((xVersion - since) >= STATE_VERSION_HISTORY)){
+		res = false;
+	} else {
+		for (uint32_t v = since + 1; v <= xVersion; v++){
+			dirtyCode |= xHistory[v % STATE_VERSION_HISTORY];
+		}
+	}
+	taskEXIT_CRITICAL();
+	return res;
+}
@@ -0,0 +1,61 @@
+/*
+ * StateVersion.h
+ *
+ * Tracks a version number for a State object. Each change notified by the
+ * State increments the version, and the slots changed by recent versions
+ * are kept so a delta since a given version can be produced.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _STATEVERSION_H_
+#define _STATEVERSION_H_
+
+#include "StateObserver.h"
+#include <stdint.h>
+
+//Number of recent versions a delta can be produced from
+#ifndef STATE_VERSION_HISTORY
+#define STATE_VERSION_HISTORY 	16
+#endif
+
+class StateVersion : public StateObserver {
+public:
+	/***
+	 * Constructor
+	 */
+	StateVersion();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~StateVersion();
+
+	/***
+	 * Notification of a change of a state item with the State object.
+	 * Increments the version
+	 * @param dirtyCode - Representation of item changed within state
+	 */
+	virtual void notifyState(uint16_t dirtyCode);
+
+	/***
+	 * Current version
+	 * @return
+	 */
+	uint32_t getVersion();
+
+	/***
+	 * Slots changed since a version
+	 * @param since - version the requester holds
+	 * @param dirtyCode - set to slots changed after that version
+	 * @return false if the version is too old or unknown, full state needed
+	 */
+	bool dirtySince(uint32_t since, uint16_t &dirtyCode);
+
+private:
+	volatile uint32_t xVersion = 0;
+	uint16_t xHistory[STATE_VERSION_HISTORY];
+};
+
+#endif /* _STATEVERSION_H_ */
@@ -0,0 +1,31 @@
+/*
+ * TempObserver.cpp
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TempObserver.h"
+#include <stdio.h>
+
+/***
+ * Constructor
+ */
+TempObserver::TempObserver() {
+	// NOP
+}
+
+/***
+ * Destructor
+ */
+TempObserver::~TempObserver() {
+	// NOP
+}
+
+/***
+ * Handle a change in the filtered temperature
+ * @param temp - filtered temperature in Celsius
+ */
+void TempObserver::handleTemp(float temp){
+	printf("Temp %.2f\n", temp);
+}
@@ -0,0 +1,33 @@
+/*
+ * TempObserver.h
+ *
+ * Virtual observer class for the temperature sampler.
+ * Any observer should inherit from this class and override handleTemp
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _TEMPOBSERVER_H_
+#define _TEMPOBSERVER_H_
+
+class TempObserver {
+public:
+	/***
+	 * Constructor - does nothing
+	 */
+	TempObserver();
+
+	/***
+	 * Destructor - does nothing
+	 */
+	virtual ~TempObserver();
+
+	/***
+	 * Handle a change in the filtered temperature
+	 * @param temp - filtered temperature in Celsius
+	 */
+	virtual void handleTemp(float temp);
+};
+
+#endif /* _TEMPOBSERVER_H_ */
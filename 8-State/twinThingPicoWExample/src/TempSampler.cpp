@@ -0,0 +1,119 @@
+/*
+ * TempSampler.cpp
+ *
+ * Samples the RP2040 on die temperature sensor on a timer and keeps an
+ * exponential moving average. Readers get the filtered value without an
+ * ADC conversion, and the observer is only told when it moves by more
+ * than a threshold.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TempSampler.h"
+#include "hardware/adc.h"
+#include "MQTTConfig.h"
+#include <math.h>
+
+/***
+ * Constructor. Sets up the ADC and takes a first reading
+ * @param ms - sample period in milliseconds
+ */
+TempSampler::TempSampler(uint32_t ms) {
+	adc_init();
+	adc_set_temp_sensor_enabled(true);
+
+	xTemp = readSensor();
+	xReported = xTemp;
+
+	xTimer = xTimerCreateStatic(
+		"TempSampler",
+		pdMS_TO_TICKS(ms),
+		pdTRUE,
+		this,
+		TempSampler::vTimerCallback,
+		&xTimerBuffer);
+	if (xTimer == NULL){
+		LogError(("Unable to create temp timer\n"));
+	}
+}
+
+/***
+ * Destructor
+ */
+TempSampler::~TempSampler() {
+	if (xTimer != NULL){
+		xTimerDelete(xTimer, 0);
+	}
+}
+
+/***
+ * Start sampling
+ * @return false if timer could not start
+ */
+bool TempSampler::start(){
+	if (xTimer == NULL){
+		return false;
+	}
+	return (xTimerStart(xTimer, 0) == pdPASS);
+}
+
+/***
+ * Set the change reported to the observer
+ * @param epsilon - degrees Celsius
+ */
+void TempSampler::setEpsilon(float epsilon){
+	xEpsilon = epsilon;
+}
+
+/***
+ * Set observer to be told of changes larger than epsilon
+ * @param observer
+ */
+void TempSampler::setObserver(TempObserver *observer){
+	pObserver = observer;
+}
+
+/***
+ * Filtered temperature
+ * @return degrees Celsius
+ */
+float TempSampler::getTemp(){
+	return xTemp;
+}
+
+/***
+ * Read the sensor once
+ * @return degrees Celsius
+ */
+float TempSampler::readSensor(){
+	const float conversionFactor = 3.3f / (1 << 12);
+
+	adc_select_input(TEMP_ADC_INPUT);
+	float v = (float)adc_read() * conversionFactor;
+	return 27.0f - (v - 0.706f) / 0.001721f;
+}
+
+/***
+ * Take a sample and update the average
+ */
+void TempSampler::sample(){
+	float t = readSensor();
+	xTemp = xTemp + TEMP_EMA_ALPHA * (t - xTemp);
+
+	if (fabsf(xTemp - xReported) > xEpsilon){
+		xReported = xTemp;
+		if (pObserver != NULL){
+			pObserver->handleTemp(xTemp);
+		}
+	}
+}
+
+/***
+ * Timer callback
+ * @param xTimer
+ */
+void TempSampler::vTimerCallback(TimerHandle_t xTimer){
+	TempSampler *sampler = (TempSampler *)pvTimerGetTimerID(xTimer);
+	sampler->sample();
+}
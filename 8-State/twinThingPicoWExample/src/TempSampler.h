@@ -0,0 +1,103 @@
+/*
+ * TempSampler.h
+ *
+ * Samples the RP2040 on die temperature sensor on a timer and keeps an
+ * exponential moving average. Readers get the filtered value without an
+ * ADC conversion, and the observer is only told when it moves by more
+ * than a threshold.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _TEMPSAMPLER_H_
+#define _TEMPSAMPLER_H_
+
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "TempObserver.h"
+
+#ifndef TEMP_SAMPLE_MS
+#define TEMP_SAMPLE_MS 		1000
+#endif
+
+//Weight of each new sample in the average
+#ifndef TEMP_EMA_ALPHA
+#define TEMP_EMA_ALPHA 		0.2f
+#endif
+
+//Change in filtered temperature reported to the observer
+#ifndef TEMP_EPSILON
+#define TEMP_EPSILON 		0.5f
+#endif
+
+//ADC input wired to the temperature sensor
+#define TEMP_ADC_INPUT 		4
+
+class TempSampler {
+public:
+	/***
+	 * Constructor. Sets up the ADC and takes a first reading
+	 * @param ms - sample period in milliseconds
+	 */
+	TempSampler(uint32_t ms = TEMP_SAMPLE_MS);
+
+	/***
+	 * Destructor
+	 */
+	virtual ~TempSampler();
+
+	/***
+	 * Start sampling
+	 * @return false if timer could not start
+	 */
+	bool start();
+
+	/***
+	 * Set the change reported to the observer
+	 * @param epsilon - degrees Celsius
+	 */
+	void setEpsilon(float epsilon);
+
+	/***
+	 * Set observer to be told of changes larger than epsilon
+	 * @param observer
+	 */
+	void setObserver(TempObserver *observer);
+
+	/***
+	 * Filtered temperature
+	 * @return degrees Celsius
+	 */
+	float getTemp();
+
+protected:
+	/***
+	 * Read the sensor once
+	 * @return degrees Celsius
+	 */
+	virtual float readSensor();
+
+	/***
+	 * Take a sample and update the average
+	 */
+	void sample();
+
+private:
+	/***
+	 * Timer callback
+	 * @param xTimer
+	 */
+	static void vTimerCallback(TimerHandle_t xTimer);
+
+	TimerHandle_t xTimer = NULL;
+	StaticTimer_t xTimerBuffer;
+
+	TempObserver *pObserver = NULL;
+
+	volatile float xTemp = 0.0f;
+	float xReported = 0.0f;
+	float xEpsilon = TEMP_EPSILON;
+};
+
+#endif /* _TEMPSAMPLER_H_ */
@@ -0,0 +1,167 @@
+/*
+ * TwinTaskCoalesce.cpp
+ *
+ * Twin task that coalesces state changes. Dirty slots are collected over
+ * a window and published as one delta, with a full state resync every
+ * so many deltas. The window timer only wakes a flush task, so the
+ * state is never serialised or published on the timer service task.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TwinTaskCoalesce.h"
+
+/***
+ * Constructor
+ */
+TwinTaskCoalesce::TwinTaskCoalesce() {
+	uint32_t ms = (xWindow > 0) ? xWindow : 1;
+	xTimer = xTimerCreateStatic(
+		"TwinCoalesce",
+		pdMS_TO_TICKS(ms),
+		pdFALSE,
+		this,
+		TwinTaskCoalesce::vTimerCallback,
+		&xTimerBuffer);
+	if (xTimer == NULL){
+		LogError(("Unable to create coalesce timer\n"));
+	}
+}
+
+/***
+ * Destructor
+ */
+TwinTaskCoalesce::~TwinTaskCoalesce() {
+	if (xTimer != NULL){
+		xTimerDelete(xTimer, 0);
+	}
+}
+
+/***
+ * Start the twin task and the flush task
+ * @param priority - Priority to apply to both
+ */
+void TwinTaskCoalesce::start(UBaseType_t priority){
+	BaseType_t res;
+
+	TwinTask::start(priority);
+
+	res = xTaskCreate(
+		TwinTaskCoalesce::vFlushTask,
+		"TwinFlush",
+		TWIN_FLUSH_STACK,
+		( void * ) this,
+		priority,
+		&xFlushHandle
+	);
+	if (res != pdPASS){
+		xFlushHandle = NULL;
+		LogError(("Unable to start twin flush task\n"));
+	}
+}
+
+/***
+ * Set the window over which changes are collected
+ * @param ms - milliseconds, zero publishes every change
+ */
+void TwinTaskCoalesce::setWindow(uint32_t ms){
+	xWindow = ms;
+	if ((xWindow > 0) && (xTimer != NULL)){
+		xTimerChangePeriod(xTimer, pdMS_TO_TICKS(xWindow), 0);
+		xTimerStop(xTimer, 0);
+	}
+}
+
+/***
+ * Set how often a full state is published instead of a delta
+ * @param deltas - number of deltas between full states, zero for never
+ */
+void TwinTaskCoalesce::setResync(uint32_t deltas){
+	xResync = deltas;
+}
+
+/***
+ * Notification of a change of a state item with the State object.
+ * Collected until the window closes
+ * @param dirtyCode - Representation of item changed within state
+ */
+void TwinTaskCoalesce::notifyState(uint16_t dirtyCode){
+	taskENTER_CRITICAL();
+	xChanges++;
+	xPending |= dirtyCode;
+	taskEXIT_CRITICAL();
+
+	//Without the timer and flush task publish from the notifier
+	if ((xWindow == 0) || (xTimer == NULL) || (xFlushHandle == NULL)){
+		flush();
+		return;
+	}
+
+	//Window runs from the first change so a steady stream still publishes
+	if (xTimerIsTimerActive(xTimer) == pdFALSE){
+		xTimerStart(xTimer, 0);
+	}
+}
+
+/***
+ * Number of state changes notified
+ * @return
+ */
+uint32_t TwinTaskCoalesce::getChanges(){
+	return xChanges;
+}
+
+/***
+ * Number of updates published
+ * @return
+ */
+uint32_t TwinTaskCoalesce::getPublishes(){
+	return xPublishes;
+}
+
+/***
+ * Timer callback when the window closes, wakes the flush task
+ * @param xTimer
+ */
+void TwinTaskCoalesce::vTimerCallback(TimerHandle_t xTimer){
+	TwinTaskCoalesce *task = (TwinTaskCoalesce *)pvTimerGetTimerID(xTimer);
+	xTaskNotifyGive(task->xFlushHandle);
+}
+
+/***
+ * Internal function used by FreeRTOS to run the flush task
+ * @param pvParameters
+ */
+void TwinTaskCoalesce::vFlushTask(void * pvParameters){
+	TwinTaskCoalesce *task = (TwinTaskCoalesce *) pvParameters;
+	for (;;){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		task->flush();
+	}
+}
+
+/***
+ * Publish the collected changes
+ */
+void TwinTaskCoalesce::flush(){
+	uint16_t dirtyCode;
+
+	taskENTER_CRITICAL();
+	dirtyCode = xPending;
+	xPending = 0;
+	taskEXIT_CRITICAL();
+
+	if (dirtyCode == 0){
+		return;
+	}
+
+	xDeltas++;
+	if ((xResync > 0) && (xDeltas >= xResync)){
+		xDeltas = 0;
+		dirtyCode = TWIN_ALL_SLOTS;
+	}
+
+	xPublishes++;
+	TwinTask::notifyState(dirtyCode);
+}
@@ -0,0 +1,123 @@
+/*
+ * TwinTaskCoalesce.h
+ *
+ * Twin task that coalesces state changes. Dirty slots are collected over
+ * a window and published as one delta, with a full state resync every
+ * so many deltas. The window timer only wakes a flush task, so the
+ * state is never serialised or published on the timer service task.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _TWINTASKCOALESCE_H_
+#define _TWINTASKCOALESCE_H_
+
+#include "TwinTask.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "task.h"
+
+//Window over which changes are collected, zero publishes every change
+#ifndef TWIN_COALESCE_MS
+#define TWIN_COALESCE_MS 	250
+#endif
+
+//Publish full state after this many deltas, zero for never
+#ifndef TWIN_RESYNC_DELTAS
+#define TWIN_RESYNC_DELTAS 	20
+#endif
+
+//Stack of the flush task in words, it serialises and publishes the state
+#ifndef TWIN_FLUSH_STACK
+#define TWIN_FLUSH_STACK 	1024
+#endif
+
+//Dirty code marking every slot
+#define TWIN_ALL_SLOTS 		0xFFFF
+
+class TwinTaskCoalesce : public TwinTask {
+public:
+	/***
+	 * Constructor
+	 */
+	TwinTaskCoalesce();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~TwinTaskCoalesce();
+
+	/***
+	 * Start the twin task and the flush task
+	 * @param priority - Priority to apply to both
+	 */
+	void start(UBaseType_t priority = tskIDLE_PRIORITY);
+
+	/***
+	 * Set the window over which changes are collected
+	 * @param ms - milliseconds, zero publishes every change
+	 */
+	void setWindow(uint32_t ms);
+
+	/***
+	 * Set how often a full state is published instead of a delta
+	 * @param deltas - number of deltas between full states, zero for never
+	 */
+	void setResync(uint32_t deltas);
+
+	/***
+	 * Notification of a change of a state item with the State object.
+	 * Collected until the window closes
+	 * @param dirtyCode - Representation of item changed within state
+	 */
+	virtual void notifyState(uint16_t dirtyCode);
+
+	/***
+	 * Number of state changes notified
+	 * @return
+	 */
+	uint32_t getChanges();
+
+	/***
+	 * Number of updates published
+	 * @return
+	 */
+	uint32_t getPublishes();
+
+private:
+	/***
+	 * Timer callback when the window closes, wakes the flush task
+	 * @param xTimer
+	 */
+	static void vTimerCallback(TimerHandle_t xTimer);
+
+	/***
+	 * Internal function used by FreeRTOS to run the flush task
+	 * @param pvParameters
+	 */
+	static void vFlushTask(void * pvParameters);
+
+	/***
+	 * Publish the collected changes
+	 */
+	void flush();
+
+	TimerHandle_t xTimer = NULL;
+	StaticTimer_t xTimerBuffer;
+	TaskHandle_t xFlushHandle = NULL;
+
+	uint32_t xWindow = TWIN_COALESCE_MS;
+	uint32_t xResync = TWIN_RESYNC_DELTAS;
+
+	//Slots changed since last publish
+	volatile uint16_t xPending = 0;
+
+	uint32_t xDeltas = 0;
+
+	//Counted within the critical section as notifiers run on several tasks
+	volatile uint32_t xChanges = 0;
+	volatile uint32_t xPublishes = 0;
+};
+
+#endif /* _TWINTASKCOALESCE_H_ */
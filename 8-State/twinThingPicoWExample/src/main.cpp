@@ -25,7 +25,7 @@
 #include "LEDAgent.h"
 #include "MQTTRouterLED.h"
 #include "LEDState.h"
-#include "TwinTask.h"
+#include "TwinTaskCoalesce.h"
 #include "MQTTPingTask.h"
 
 
@@ -167,8 +167,11 @@ void main_task(void *params){
 	mqttAgent.mqttConnect(mqttTarget, mqttPort, true);
 	mqttAgent.start(TASK_PRIORITY);
 
+	TempSampler tempSampler;
 	LEDState ledState;
-	TwinTask twinTask;
+	ledState.setSampler(&tempSampler);
+	tempSampler.start();
+	TwinTaskCoalesce twinTask;
 	twinTask.setStateObject(&ledState);
 	twinTask.setMQTTInterface(&mqttAgent);
 	twinTask.start(TASK_PRIORITY);
@@ -182,15 +185,83 @@ void main_task(void *params){
 	xPing.start(TASK_PRIORITY);
 	router.setPingTask(&xPing, &mqttAgent);
 	router.setTwin(&twinTask);
+	router.setState(&ledState);
 	mqttAgent.setRouter(&router);
 
 
+	uint32_t twinChanges = 0;
+	uint32_t twinGets = 0;
+	uint32_t staleDrops = 0;
+	uint32_t batches = 0;
+	uint32_t cacheGets = 0;
+	unsigned int ledStack = 0;
+	uint32_t cborReqs = 0;
+
     while(true) {
 
     	//runTimeStats();
 
         vTaskDelay(3000);
 
+        //Report how many state changes were coalesced into each update
+        if (twinTask.getChanges() != twinChanges){
+        	twinChanges = twinTask.getChanges();
+        	printf("Twin changes %u, updates published %u\n",
+        			twinChanges,
+        			twinTask.getPublishes());
+        }
+
+        //Report conditional GETs, not modified replies save a full state
+        if ((router.getNotModified() + router.getConditional()) != twinGets){
+        	twinGets = router.getNotModified() + router.getConditional();
+        	printf("Conditional GET %u, not modified %u\n",
+        			twinGets,
+        			router.getNotModified());
+        }
+
+        //Report stale commands dropped by sequence number
+        if ((ledAgent.getDropped() + router.getSetDropped()) != staleDrops){
+        	staleDrops = ledAgent.getDropped() + router.getSetDropped();
+        	printf("Stale commands dropped LED %u, SET %u\n",
+        			ledAgent.getDropped(),
+        			router.getSetDropped());
+        }
+
+        //Report batched scene changes, each is applied with one update
+        if ((ledAgent.getBatchCmds() + router.getBatchCmds()) != batches){
+        	batches = ledAgent.getBatchCmds() + router.getBatchCmds();
+        	printf("LED batches %u of %u cmds, rejected %u, apply %u us\n",
+        			ledAgent.getBatches(),
+        			ledAgent.getBatchCmds(),
+        			ledAgent.getBatchRejected(),
+        			ledAgent.getApplyUs());
+        	printf("SET batches %u of %u cmds, rejected %u, merge %u us\n",
+        			router.getBatches(),
+        			router.getBatchCmds(),
+        			router.getBatchRejected(),
+        			router.getBatchUs());
+        }
+
+        //Report twin requests made over CBOR
+        if (router.getCborReqs() != cborReqs){
+        	cborReqs = router.getCborReqs();
+        	printf("CBOR GET/SET %u\n", cborReqs);
+        }
+
+        //Report slot fragments reused from the cache against rendered
+        if ((ledState.getCacheHits() + ledState.getCacheMisses()) != cacheGets){
+        	cacheGets = ledState.getCacheHits() + ledState.getCacheMisses();
+        	printf("State slot cache hits %u, misses %u\n",
+        			ledState.getCacheHits(),
+        			ledState.getCacheMisses());
+        }
+
+        //Report the least stack the LED agent has had spare
+        if (ledAgent.getStakHighWater() != ledStack){
+        	ledStack = ledAgent.getStakHighWater();
+        	printf("LEDAgent stack high water %u words\n", ledStack);
+        }
+
         if (!WifiHelper::isJoined()){
         	printf("AP Link is down\n");
 
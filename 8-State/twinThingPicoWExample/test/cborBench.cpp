@@ -0,0 +1,202 @@
+/*
+ * cborBench.cpp
+ *
+ * Host benchmark of the twin state as JSON against CBOR. Reports the
+ * bytes per message and the encode and decode times of each, for the
+ * LED state alone and for a state with a temperature and counters.
+ * Each decode must give back the state encoded. Also times CborJson,
+ * which the router uses to carry the whole twin document over the
+ * CBOR topics, and checks it round trips.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "StateFields.h"
+#include "CborJson.h"
+
+#define BENCH_LOOPS 		20000
+#define BENCH_JSON_POOL 	10
+#define BENCH_MSG_LEN 		128
+
+class BenchState {
+public:
+	bool getOn() const { return xOn; }
+	void setOn(bool b) { xOn = b; }
+	double getTemp() const { return xTemp; }
+	void setTemp(double t) { xTemp = t; }
+	int getLevel() const { return xLevel; }
+	void setLevel(int l) { xLevel = l; }
+	int getCount() const { return xCount; }
+	void setCount(int c) { xCount = c; }
+
+	bool operator==(const BenchState &o) const {
+		return (xOn == o.xOn) && (xTemp == o.xTemp) &&
+			(xLevel == o.xLevel) && (xCount == o.xCount);
+	}
+
+private:
+	bool xOn = true;
+	double xTemp = 21.5;
+	int xLevel = 200;
+	int xCount = 123456;
+};
+
+//As LEDState
+static constexpr auto xLEDFields = stateFields(
+	stateField("on", 0, &BenchState::getOn, &BenchState::setOn)
+);
+
+static constexpr auto xTwinFields = stateFields(
+	stateField("on", 0, &BenchState::getOn, &BenchState::setOn),
+	stateField("temp", 1, &BenchState::getTemp, &BenchState::setTemp),
+	stateField("level", 2, &BenchState::getLevel, &BenchState::setLevel),
+	stateField("count", 3, &BenchState::getCount, &BenchState::setCount)
+);
+
+typedef std::chrono::steady_clock BenchClock;
+
+/***
+ * Mean nano seconds of a duration over the loops
+ * @param d
+ * @return
+ */
+static double perLoop(BenchClock::duration d){
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()
+			/ BENCH_LOOPS;
+}
+
+/***
+ * Encode and decode a state both ways and report sizes and times
+ * @param name - name of the field set
+ * @param fields - field set
+ * @return false if a decode did not give back the state
+ */
+template<class F>
+static bool bench(const char *name, const F &fields){
+	BenchState src;
+	char json[BENCH_MSG_LEN];
+	char jsonCopy[BENCH_MSG_LEN];
+	json_t pool[BENCH_JSON_POOL];
+	uint8_t cbor[BENCH_MSG_LEN];
+	size_t jsonLen = 0;
+	size_t cborLen = 0;
+	bool pass = true;
+
+	//JSON encode, one slot at a time as State::state does
+	auto start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		size_t remLen = sizeof(json);
+		char *p = json_objOpen(json, NULL, &remLen);
+		for (uint16_t slot=0; slot < fields.size(); slot++){
+			p = fields.write(&src, slot, p, remLen);
+			remLen = sizeof(json) - (p - json);
+		}
+		p = json_objClose(p, &remLen);
+		p = json_end(p, &remLen);
+		jsonLen = p - json;
+	}
+	double jsonEnc = perLoop(BenchClock::now() - start);
+
+	//JSON decode, tiny-json parses in place so needs a fresh copy
+	BenchState fromJson;
+	fromJson.setOn(false);
+	start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		memcpy(jsonCopy, json, jsonLen + 1);
+		json_t const *j = json_create(jsonCopy, pool, BENCH_JSON_POOL);
+		if (j == NULL){
+			pass = false;
+			break;
+		}
+		fields.update(&fromJson, j);
+	}
+	double jsonDec = perLoop(BenchClock::now() - start);
+
+	//CBOR encode
+	start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		CborWriter w(cbor, sizeof(cbor));
+		fields.writeCbor(&src, w);
+		cborLen = w.length();
+	}
+	double cborEnc = perLoop(BenchClock::now() - start);
+
+	//CBOR decode
+	BenchState fromCbor;
+	fromCbor.setOn(false);
+	start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		CborReader r(cbor, cborLen);
+		if (!fields.updateCbor(&fromCbor, r)){
+			pass = false;
+			break;
+		}
+	}
+	double cborDec = perLoop(BenchClock::now() - start);
+
+	//JSON document to CBOR, as the router answers a CBOR GET
+	uint8_t conv[BENCH_MSG_LEN];
+	size_t convLen = 0;
+	start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		memcpy(jsonCopy, json, jsonLen + 1);
+		json_t const *j = json_create(jsonCopy, pool, BENCH_JSON_POOL);
+		CborWriter w(conv, sizeof(conv));
+		if ((j == NULL) || !CborJson::fromJson(j, w)){
+			pass = false;
+			break;
+		}
+		convLen = w.length();
+	}
+	double toCbor = perLoop(BenchClock::now() - start);
+
+	//And back, as the router turns a CBOR SET into a JSON SET
+	char back[BENCH_MSG_LEN];
+	unsigned int backLen = 0;
+	start = BenchClock::now();
+	for (int i=0; i < BENCH_LOOPS; i++){
+		backLen = CborJson::toJson(conv, convLen, back, sizeof(back));
+		if (backLen == 0){
+			pass = false;
+			break;
+		}
+	}
+	double toJson = perLoop(BenchClock::now() - start);
+
+	BenchState fromConv;
+	fromConv.setOn(false);
+	json_t const *j = json_create(back, pool, BENCH_JSON_POOL);
+	if ((j == NULL) || (convLen != cborLen)){
+		pass = false;
+	} else {
+		fields.update(&fromConv, j);
+	}
+
+	printf("%-6s JSON %3zu bytes, encode %6.0f ns, decode %6.0f ns  %s\n",
+			name, jsonLen, jsonEnc, jsonDec, json);
+	printf("%-6s CBOR %3zu bytes, encode %6.0f ns, decode %6.0f ns\n",
+			name, cborLen, cborEnc, cborDec);
+	printf("%-6s CborJson %3zu bytes, to CBOR %6.0f ns, to JSON %6.0f ns\n",
+			name, convLen, toCbor, toJson);
+
+	if (!pass || !(fromJson == src) || !(fromCbor == src) ||
+			!(fromConv == src)){
+		printf("FAIL: %s did not decode to the state encoded\n", name);
+		return false;
+	}
+	return true;
+}
+
+int main(){
+	bool pass = bench("LED", xLEDFields);
+	pass = bench("Twin", xTwinFields) && pass;
+	if (!pass){
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * slotCacheBench.cpp
+ *
+ * Host benchmark of serialising a state against its slot count, rendering
+ * every slot each time against copying unchanged slots from
+ * StateSlotCache. One slot changes between each serialisation, as with a
+ * twin update. Both must produce the same JSON.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "StateFields.h"
+#include "StateSlotCache.h"
+
+#define BENCH_LOOPS 		20000
+#define BENCH_JSON_LEN 		512
+
+class BenchState {
+public:
+#define BENCH_MEMBER(N) \
+	double get_##N() const { return x_##N; } \
+	void set_##N(double v) { x_##N = v; } \
+	double x_##N = 21.25 + N;
+	BENCH_MEMBER(0) BENCH_MEMBER(1) BENCH_MEMBER(2) BENCH_MEMBER(3)
+	BENCH_MEMBER(4) BENCH_MEMBER(5) BENCH_MEMBER(6) BENCH_MEMBER(7)
+#undef BENCH_MEMBER
+
+	/***
+	 * Change the value of a slot
+	 * @param slot
+	 * @param v
+	 */
+	void change(uint16_t slot, double v){
+		switch(slot){
+		case 0: set_0(v); break;
+		case 1: set_1(v); break;
+		case 2: set_2(v); break;
+		case 3: set_3(v); break;
+		case 4: set_4(v); break;
+		case 5: set_5(v); break;
+		case 6: set_6(v); break;
+		default: set_7(v); break;
+		}
+	}
+};
+
+#define BENCH_FIELD(N) \
+	stateField("slot" #N, N, &BenchState::get_##N, &BenchState::set_##N)
+
+static constexpr auto xFields = stateFields(
+	BENCH_FIELD(0), BENCH_FIELD(1), BENCH_FIELD(2), BENCH_FIELD(3),
+	BENCH_FIELD(4), BENCH_FIELD(5), BENCH_FIELD(6), BENCH_FIELD(7)
+);
+
+/***
+ * Serialise the first slots of the state, as State::state does
+ * @param s - state
+ * @param slots - number of slots
+ * @param cache - cache to use, NULL to render every slot
+ * @param buf
+ * @param len
+ * @return length of json
+ */
+static size_t serialise(const BenchState *s, uint16_t slots,
+		StateSlotCache *cache, char *buf, size_t len){
+	size_t remLen = len;
+	char *p = json_objOpen(buf, NULL, &remLen);
+	for (uint16_t slot=0; slot < slots; slot++){
+		char *start = p;
+		uint32_t gen = 0;
+		p = NULL;
+		if (cache != NULL){
+			gen = cache->generation(slot);
+			p = cache->get(slot, start, remLen);
+		}
+		if (p == NULL){
+			p = xFields.write(s, slot, start, remLen);
+			if ((cache != NULL) && ((size_t)(p - start) + 1 < remLen)){
+				cache->put(slot, gen, start, p);
+			}
+		}
+		remLen = len - (p - buf);
+	}
+	p = json_objClose(p, &remLen);
+	p = json_end(p, &remLen);
+	return p - buf;
+}
+
+/***
+ * Time serialisations of a state with one slot changed before each
+ * @param slots - number of slots
+ * @param cache - cache to use, NULL to render every slot
+ * @param out - last JSON produced
+ * @return mean nano seconds per serialisation
+ */
+static double timeSerialise(uint16_t slots, StateSlotCache *cache, char *out){
+	BenchState s;
+	std::chrono::nanoseconds total(0);
+	for (int i=0; i < BENCH_LOOPS; i++){
+		uint16_t slot = i % slots;
+		s.change(slot, 20.0 + (i % 97) / 8.0);
+		if (cache != NULL){
+			cache->notifyState(1 << slot);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		serialise(&s, slots, cache, out, BENCH_JSON_LEN);
+		total += std::chrono::steady_clock::now() - start;
+	}
+	return (double)total.count() / BENCH_LOOPS;
+}
+
+int main(){
+	char rendered[BENCH_JSON_LEN];
+	char cached[BENCH_JSON_LEN];
+	bool pass = true;
+
+	printf("slots  render ns  cached ns  hits  misses\n");
+	for (uint16_t slots=1; slots <= xFields.size(); slots++){
+		StateSlotCache cache;
+		double renderNs = timeSerialise(slots, NULL, rendered);
+		double cachedNs = timeSerialise(slots, &cache, cached);
+		printf("%5u  %9.0f  %9.0f  %lu  %lu\n", slots, renderNs, cachedNs,
+				(unsigned long)cache.getHits(),
+				(unsigned long)cache.getMisses());
+
+		if (strcmp(rendered, cached) != 0){
+			printf("FAIL: cached JSON differs\n%s\n%s\n", rendered, cached);
+			pass = false;
+		}
+	}
+
+	//A fragment too long for the buffer must not be kept
+	StateSlotCache cache;
+	BenchState s;
+	char small[12];
+	serialise(&s, 1, &cache, small, sizeof(small));
+	if (cache.get(0, rendered, sizeof(rendered)) != NULL){
+		printf("FAIL: truncated fragment cached\n");
+		pass = false;
+	}
+
+	//A fragment rendered while its slot was invalidated must not be kept
+	uint32_t gen = cache.generation(1);
+	const char frag[] = "\"slot1\":1";
+	cache.notifyState(1 << 1);
+	cache.put(1, gen, frag, frag + strlen(frag));
+	if (cache.get(1, rendered, sizeof(rendered)) != NULL){
+		printf("FAIL: stale fragment cached after invalidate\n");
+		pass = false;
+	}
+	cache.put(1, cache.generation(1), frag, frag + strlen(frag));
+	if (cache.get(1, rendered, sizeof(rendered)) == NULL){
+		printf("FAIL: current fragment not cached\n");
+		pass = false;
+	}
+
+	if (!pass){
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
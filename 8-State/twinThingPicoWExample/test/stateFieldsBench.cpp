@@ -0,0 +1,229 @@
+/*
+ * stateFieldsBench.cpp
+ *
+ * Host benchmark of StateFields::update against looking up each field
+ * with json_getProperty, on a state object of 30 fields each in a slot
+ * of its own. Both must leave the object in the same state, and
+ * updates must mark only the slots of the fields they set.
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "StateFields.h"
+
+#define BENCH_LOOPS 		20000
+#define BENCH_JSON_POOL 	40
+#define BENCH_JSON_LEN 		1024
+
+//Ten of each type, named i0..i9, b0..b9 and d0..d9, in slots 0..29.
+//F is used for the first field and X for the rest
+#define BENCH_LIST(F, X) \
+	F(int, i0, 0) X(int, i1, 1) X(int, i2, 2) X(int, i3, 3) X(int, i4, 4) \
+	X(int, i5, 5) X(int, i6, 6) X(int, i7, 7) X(int, i8, 8) X(int, i9, 9) \
+	X(bool, b0, 10) X(bool, b1, 11) X(bool, b2, 12) X(bool, b3, 13) \
+	X(bool, b4, 14) X(bool, b5, 15) X(bool, b6, 16) X(bool, b7, 17) \
+	X(bool, b8, 18) X(bool, b9, 19) \
+	X(double, d0, 20) X(double, d1, 21) X(double, d2, 22) X(double, d3, 23) \
+	X(double, d4, 24) X(double, d5, 25) X(double, d6, 26) X(double, d7, 27) \
+	X(double, d8, 28) X(double, d9, 29)
+#define BENCH_FIELDS(X) BENCH_LIST(X, X)
+
+class BenchState {
+public:
+#define BENCH_MEMBER(T, N, S) \
+	T get_##N() const { return x_##N; } \
+	void set_##N(T v) { x_##N = v; xDirty |= 1UL << S; } \
+	T x_##N = T();
+	BENCH_FIELDS(BENCH_MEMBER)
+#undef BENCH_MEMBER
+
+	//Slots set since last cleared, as State::setDirty
+	uint32_t xDirty = 0;
+
+	bool operator==(const BenchState &o) const {
+		bool same = true;
+#define BENCH_SAME(T, N, S) same = same && (x_##N == o.x_##N);
+		BENCH_FIELDS(BENCH_SAME)
+#undef BENCH_SAME
+		return same;
+	}
+};
+
+#define BENCH_FIELD(T, N, S) \
+	stateField(#N, S, &BenchState::get_##N, &BenchState::set_##N)
+#define BENCH_NEXT_FIELD(T, N, S) , BENCH_FIELD(T, N, S)
+
+static constexpr auto xFields = stateFields(
+	BENCH_LIST(BENCH_FIELD, BENCH_NEXT_FIELD)
+);
+
+/***
+ * Update each field with its own json_getProperty, as the states
+ * were written before StateFields
+ * @param s - state to update
+ * @param json - parsed JSON object
+ */
+static void updateByProperty(BenchState *s, json_t const *json){
+	json_t const *jp;
+#define BENCH_PROPERTY(T, N, S) \
+	jp = json_getProperty(json, #N); \
+	if (jp != NULL){ \
+		T v; \
+		if (stateFieldRead(jp, v)){ \
+			s->set_##N(v); \
+		} \
+	}
+	BENCH_FIELDS(BENCH_PROPERTY)
+#undef BENCH_PROPERTY
+}
+
+/***
+ * Value written for the nth field
+ * @param n
+ * @return
+ */
+template<class T>
+static T benchValue(int n){
+	return (T)n;
+}
+
+template<>
+bool benchValue<bool>(int n){
+	return (n % 2) != 0;
+}
+
+/***
+ * Build the JSON of a full 30 field update
+ * @param buf
+ * @param len
+ */
+static void buildJson(char *buf, size_t len){
+	size_t remLen = len;
+	char *p = json_objOpen(buf, NULL, &remLen);
+	int i = 0;
+#define BENCH_JSON(T, N, S) \
+	{ T v = benchValue<T>((i + 1) * 3); p = stateFieldWrite(p, #N, v, &remLen); i++; }
+	BENCH_FIELDS(BENCH_JSON)
+#undef BENCH_JSON
+	p = json_objClose(p, &remLen);
+	json_end(p, &remLen);
+}
+
+/***
+ * Time a parse and update of a fresh copy of the JSON
+ * @param src - JSON text
+ * @param s - state to update
+ * @param fields - true to use StateFields, false for json_getProperty
+ * @return mean nano seconds per update
+ */
+static double timeUpdate(const char *src, BenchState *s, bool fields){
+	static char buf[BENCH_JSON_LEN];
+	static json_t pool[BENCH_JSON_POOL];
+	size_t len = strlen(src) + 1;
+
+	std::chrono::nanoseconds total(0);
+	for (int i=0; i < BENCH_LOOPS; i++){
+		//tiny-json parses in place so needs a fresh copy
+		memcpy(buf, src, len);
+		json_t const *json = json_create(buf, pool, BENCH_JSON_POOL);
+		if (json == NULL){
+			printf("JSON parse failed\n");
+			return -1.0;
+		}
+		auto start = std::chrono::steady_clock::now();
+		if (fields){
+			xFields.update(s, json);
+		} else {
+			updateByProperty(s, json);
+		}
+		total += std::chrono::steady_clock::now() - start;
+	}
+	return (double)total.count() / BENCH_LOOPS;
+}
+
+/***
+ * Check an update of a few fields, with an unknown one, marks only
+ * their slots
+ * @return false on failure
+ */
+static bool checkPartial(){
+	char json[] = "{\"d4\":1.5,\"nope\":1,\"i2\":7,\"b9\":true}";
+	json_t pool[BENCH_JSON_POOL];
+	BenchState s;
+
+	json_t const *j = json_create(json, pool, BENCH_JSON_POOL);
+	if (j == NULL){
+		printf("FAIL: partial JSON parse failed\n");
+		return false;
+	}
+	xFields.update(&s, j);
+	uint32_t expect = (1UL << 24) | (1UL << 2) | (1UL << 19);
+	if ((s.xDirty != expect) || (s.get_i2() != 7) || !s.get_b9() ||
+			(s.get_d4() != 1.5)){
+		printf("FAIL: partial update dirtied slots 0x%08x\n", s.xDirty);
+		return false;
+	}
+	return true;
+}
+
+/***
+ * Check each slot serialises only its own field
+ * @param s - state to write
+ * @return false on failure
+ */
+static bool checkSlots(const BenchState *s){
+	char buf[64];
+	char expect[64];
+	size_t remLen;
+#define BENCH_SLOT(T, N, S) \
+	remLen = sizeof(expect); \
+	*stateFieldWrite(expect, #N, s->get_##N(), &remLen) = 0; \
+	*xFields.write(s, S, buf, sizeof(buf)) = 0; \
+	if (strcmp(buf, expect) != 0){ \
+		printf("FAIL: slot %d wrote %s not %s\n", S, buf, expect); \
+		return false; \
+	}
+	BENCH_FIELDS(BENCH_SLOT)
+#undef BENCH_SLOT
+	return true;
+}
+
+int main(){
+	char json[BENCH_JSON_LEN];
+	buildJson(json, sizeof(json));
+	printf("%zu fields, %zu bytes of JSON\n", xFields.size(), strlen(json));
+
+	BenchState byFields;
+	BenchState byProperty;
+	double fieldsNs = timeUpdate(json, &byFields, true);
+	double propertyNs = timeUpdate(json, &byProperty, false);
+	if ((fieldsNs < 0.0) || (propertyNs < 0.0)){
+		return 1;
+	}
+
+	printf("StateFields::update    %8.0f ns\n", fieldsNs);
+	printf("json_getProperty/field %8.0f ns\n", propertyNs);
+
+	if (!(byFields == byProperty)){
+		printf("FAIL: StateFields and json_getProperty disagree\n");
+		return 1;
+	}
+	if ((byFields.get_i9() != 30) || !byFields.get_b0() ||
+			byFields.get_b1() || (byFields.get_d9() != 90.0)){
+		printf("FAIL: fields not updated\n");
+		return 1;
+	}
+	if (byFields.xDirty != 0x3FFFFFFFUL){
+		printf("FAIL: full update dirtied slots 0x%08x\n", byFields.xDirty);
+		return 1;
+	}
+	if (!checkPartial() || !checkSlots(&byFields)){
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
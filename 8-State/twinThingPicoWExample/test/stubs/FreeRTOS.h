@@ -0,0 +1,19 @@
+/*
+ * FreeRTOS.h
+ *
+ * Host stand in for the parts of FreeRTOS used by StateSlotCache
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+
+//Single threaded on the host
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* _HOST_FREERTOS_H_ */
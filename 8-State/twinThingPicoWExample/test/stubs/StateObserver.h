@@ -0,0 +1,26 @@
+/*
+ * StateObserver.h
+ *
+ * Host stand in for the twinThingPicoW StateObserver interface
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _STATEOBSERVER_H_
+#define _STATEOBSERVER_H_
+
+#include <stdint.h>
+
+class StateObserver {
+public:
+	virtual ~StateObserver() {}
+
+	/***
+	 * Notification of a change of a state item with the State object.
+	 * @param dirtyCode - Representation of item changed within state
+	 */
+	virtual void notifyState(uint16_t dirtyCode) = 0;
+};
+
+#endif /* _STATEOBSERVER_H_ */
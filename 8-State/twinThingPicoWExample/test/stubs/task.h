@@ -0,0 +1,15 @@
+/*
+ * task.h
+ *
+ * Host stand in for FreeRTOS task.h, critical sections are in FreeRTOS.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef _HOST_TASK_H_
+#define _HOST_TASK_H_
+
+#include "FreeRTOS.h"
+
+#endif /* _HOST_TASK_H_ */